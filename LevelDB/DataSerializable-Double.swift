@@ -14,9 +14,23 @@ extension Double : DataSerializable {
         }
     }
 
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Double? {
+        return OrderPreservingValue.fromSerializedBytes(bytes).map {value in
+            Double(orderPreservingValue: value)
+        }
+    }
+
     public var serializedData: Data {
         return orderPreservingValue.serializedData as Data
     }
+
+    public var serializedByteCount: Int {
+        return MemoryLayout<OrderPreservingValue>.size
+    }
+
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return orderPreservingValue.serialize(into: buffer)
+    }
 }
 
 extension Double {
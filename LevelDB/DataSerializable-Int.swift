@@ -14,9 +14,23 @@ extension Int : DataSerializable {
         }
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Int? {
+        return UInt.fromSerializedBytes(bytes).map {u in
+            Int(bitPattern: offsetSign(u))
+        }
+    }
+    
     public var serializedData: Data {
         return offsetSign(UInt(bitPattern: self)).serializedData as Data
     }
+    
+    public var serializedByteCount: Int {
+        return offsetSign(UInt(bitPattern: self)).serializedByteCount
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return offsetSign(UInt(bitPattern: self)).serialize(into: buffer)
+    }
 }
 
 extension Int8 : DataSerializable {
@@ -26,9 +40,23 @@ extension Int8 : DataSerializable {
         }
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Int8? {
+        return UInt8.fromSerializedBytes(bytes).map {u in
+            Int8(bitPattern: offsetSign(u))
+        }
+    }
+    
     public var serializedData: Data {
         return offsetSign(UInt8(bitPattern: self)).serializedData as Data
     }
+    
+    public var serializedByteCount: Int {
+        return offsetSign(UInt8(bitPattern: self)).serializedByteCount
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return offsetSign(UInt8(bitPattern: self)).serialize(into: buffer)
+    }
 }
 
 extension Int16 : DataSerializable {
@@ -38,9 +66,23 @@ extension Int16 : DataSerializable {
         }
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Int16? {
+        return UInt16.fromSerializedBytes(bytes).map {u in
+            Int16(bitPattern: offsetSign(u))
+        }
+    }
+    
     public var serializedData: Data {
         return offsetSign(UInt16(bitPattern: self)).serializedData as Data
     }
+    
+    public var serializedByteCount: Int {
+        return offsetSign(UInt16(bitPattern: self)).serializedByteCount
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return offsetSign(UInt16(bitPattern: self)).serialize(into: buffer)
+    }
 }
 
 extension Int32 : DataSerializable {
@@ -50,9 +92,23 @@ extension Int32 : DataSerializable {
         }
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Int32? {
+        return UInt32.fromSerializedBytes(bytes).map {u in
+            Int32(bitPattern: offsetSign(u))
+        }
+    }
+    
     public var serializedData: Data {
         return offsetSign(UInt32(bitPattern: self)).serializedData as Data
     }
+    
+    public var serializedByteCount: Int {
+        return offsetSign(UInt32(bitPattern: self)).serializedByteCount
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return offsetSign(UInt32(bitPattern: self)).serialize(into: buffer)
+    }
 }
 
 extension Int64 : DataSerializable {
@@ -62,9 +118,23 @@ extension Int64 : DataSerializable {
         }
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Int64? {
+        return UInt64.fromSerializedBytes(bytes).map {u in
+            Int64(bitPattern: offsetSign(u))
+        }
+    }
+    
     public var serializedData: Data {
         return offsetSign(UInt64(bitPattern: self)).serializedData as Data
     }
+    
+    public var serializedByteCount: Int {
+        return offsetSign(UInt64(bitPattern: self)).serializedByteCount
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return offsetSign(UInt64(bitPattern: self)).serialize(into: buffer)
+    }
 }
 
 // MARK: - Implementation details
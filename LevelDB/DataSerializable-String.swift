@@ -5,14 +5,31 @@
 //  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
 //
 
-import Foundation.NSData
+import Foundation
 
 extension String : DataSerializable {
     public static func fromSerializedData(_ data: Data) -> String? {
         return String(data: data, encoding: .utf8)
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> String? {
+        // Validate and copy the UTF-8 straight into one `NSString`, which
+        // bridges to `String` without another copy.
+        guard let base = bytes.baseAddress, bytes.count > 0 else { return "" }
+        return NSString(bytes: base, length: bytes.count, encoding: String.Encoding.utf8.rawValue)
+            .map {s in s as String}
+    }
+    
     public var serializedData: Data {
         return data(using: .utf8)!
     }
+    
+    public var serializedByteCount: Int {
+        return utf8.count
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        buffer.copyBytes(from: utf8)
+        return utf8.count
+    }
 }
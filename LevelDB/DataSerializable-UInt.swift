@@ -9,16 +9,29 @@ import Foundation.NSData
 
 extension UInt : DataSerializable {
     public static func fromSerializedData(_ data: Data) -> UInt? {
-        if let u: UInt64 = fromData(data), u <= UInt64(UInt.max) {
-            return UInt(u)
-        } else {
-            return nil
-        }
+        return UInt64.fromSerializedData(data).flatMap(UInt.init(exactly64:))
+    }
+    
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> UInt? {
+        return UInt64.fromSerializedBytes(bytes).flatMap(UInt.init(exactly64:))
     }
     
     public var serializedData: Data {
         return UInt64(self).serializedData
     }
+    
+    public var serializedByteCount: Int {
+        return MemoryLayout<UInt64>.size
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return UInt64(self).serialize(into: buffer)
+    }
+    
+    private init?(exactly64 u: UInt64) {
+        guard u <= UInt64(UInt.max) else { return nil }
+        self.init(u)
+    }
 }
 
 extension UInt8 : DataSerializable {
@@ -26,9 +39,21 @@ extension UInt8 : DataSerializable {
         return fromData(data)
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> UInt8? {
+        return fromBytes(bytes)
+    }
+    
     public var serializedData: Data {
         return toData(self)
     }
+    
+    public var serializedByteCount: Int {
+        return MemoryLayout<UInt8>.size
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return toBytes(self, buffer)
+    }
 }
 
 extension UInt16 : DataSerializable {
@@ -36,9 +61,20 @@ extension UInt16 : DataSerializable {
         return fromData(data)
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> UInt16? {
+        return fromBytes(bytes)
+    }
+    
     public var serializedData: Data {
-        return toData(UInt8(self >> 8 & 0xff),
-                      UInt8(self >> 0 & 0xff))
+        return toData(self)
+    }
+    
+    public var serializedByteCount: Int {
+        return MemoryLayout<UInt16>.size
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return toBytes(self, buffer)
     }
 }
 
@@ -47,11 +83,20 @@ extension UInt32 : DataSerializable {
         return fromData(data)
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> UInt32? {
+        return fromBytes(bytes)
+    }
+    
     public var serializedData: Data {
-        return toData(UInt8(self >> 24 & 0xff),
-                      UInt8(self >> 16 & 0xff),
-                      UInt8(self >>  8 & 0xff),
-                      UInt8(self >>  0 & 0xff))
+        return toData(self)
+    }
+    
+    public var serializedByteCount: Int {
+        return MemoryLayout<UInt32>.size
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return toBytes(self, buffer)
     }
 }
 
@@ -60,31 +105,48 @@ extension UInt64 : DataSerializable {
         return fromData(data)
     }
     
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> UInt64? {
+        return fromBytes(bytes)
+    }
+    
     public var serializedData: Data {
-        return toData(UInt8(self >> 56 & 0xff),
-                      UInt8(self >> 48 & 0xff),
-                      UInt8(self >> 40 & 0xff),
-                      UInt8(self >> 32 & 0xff),
-                      UInt8(self >> 24 & 0xff),
-                      UInt8(self >> 16 & 0xff),
-                      UInt8(self >>  8 & 0xff),
-                      UInt8(self >>  0 & 0xff))
+        return toData(self)
+    }
+    
+    public var serializedByteCount: Int {
+        return MemoryLayout<UInt64>.size
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        return toBytes(self, buffer)
     }
 }
 
 // MARK: - Implementation details
 
-private func fromData<T : UnsignedInteger>(_ data: Data) -> T? {
-    if (data.count != MemoryLayout<T>.size) {
-        return nil
-    } else {
-        let bytes = UnsafeBufferPointer(start: (data as NSData).bytes.bindMemory(to: UInt8.self, capacity: data.count), count: data.count)
-        return T(bytes.reduce(UIntMax(0)) {total, n -> UIntMax in total * 256 + UIntMax(n)})
-    }
+// The integers are serialized in big-endian byte order, which makes their
+// lexicographical order match the numeric one.
+
+private func fromBytes<T : FixedWidthInteger>(_ bytes: UnsafeRawBufferPointer) -> T? {
+    guard bytes.count == MemoryLayout<T>.size else { return nil }
+    var value: T = 0
+    withUnsafeMutableBytes(of: &value) {p in p.copyBytes(from: bytes)}
+    return T(bigEndian: value)
+}
+
+private func toBytes<T : FixedWidthInteger>(_ value: T, _ buffer: UnsafeMutableRawBufferPointer) -> Int {
+    var bigEndian = value.bigEndian
+    withUnsafeBytes(of: &bigEndian) {p in buffer.copyBytes(from: p)}
+    return MemoryLayout<T>.size
 }
 
-private func toData(_ bytes: UInt8...) -> Data {
-    return bytes.withUnsafeBufferPointer {ptr in
-        return Data(bytes: UnsafePointer<UInt8>(ptr.baseAddress!), count: ptr.count)
+private func fromData<T : FixedWidthInteger>(_ data: Data) -> T? {
+    return data.withUnsafeBytes {(p: UnsafePointer<UInt8>) in
+        fromBytes(UnsafeRawBufferPointer(start: p, count: data.count))
     }
 }
+
+private func toData<T : FixedWidthInteger>(_ value: T) -> Data {
+    var bigEndian = value.bigEndian
+    return Data(bytes: &bigEndian, count: MemoryLayout<T>.size)
+}
@@ -27,4 +27,39 @@ public protocol DataSerializable {
     /// all values of `x`.
     var serializedData: Data { get }
     
+    /// Create an instance from the serialized bytes borrowed in `bytes`, which
+    /// need not outlive the call. This allows decoding database contents in
+    /// place without copying them into `Data` first.
+    ///
+    /// The default implementation copies `bytes` into `Data` and calls
+    /// `fromSerializedData`.
+    static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Self?
+    
+    /// The number of bytes `serialize(into:)` writes.
+    var serializedByteCount: Int { get }
+    
+    /// Write the serialized bytes of `self` at the beginning of `buffer`, which
+    /// must have room for at least `serializedByteCount` bytes, and return the
+    /// number of bytes written.
+    func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int
+    
+}
+
+extension DataSerializable {
+
+    public static func fromSerializedBytes(_ bytes: UnsafeRawBufferPointer) -> Self? {
+        let data = bytes.baseAddress.map {p in Data(bytes: p, count: bytes.count)}
+        return fromSerializedData(data ?? Data())
+    }
+    
+    public var serializedByteCount: Int {
+        return serializedData.count
+    }
+    
+    public func serialize(into buffer: UnsafeMutableRawBufferPointer) -> Int {
+        let data = serializedData
+        buffer.copyBytes(from: data)
+        return data.count
+    }
+
 }
@@ -38,6 +38,19 @@ extern NSString * const LDBOptionBlockRestartInterval; // NSNumber with int > 0
 extern NSString * const LDBOptionCompression;     // NSNumber with LDBCompression
 extern NSString * const LDBOptionReuseLogs;       // NSNumber with BOOL
 extern NSString * const LDBOptionBloomFilterBits; // NSNumber with integer 0…32
+extern NSString * const LDBOptionLogSizeLimit;    // NSNumber with size_t, 0 = none
+
+// Keys of `-[LDBDatabase recoveryStatistics]`, all values `NSNumber`s.
+extern NSString * const LDBRecoveryTotalTime;     // NSTimeInterval
+extern NSString * const LDBRecoveryManifestBytes; // uint64_t
+extern NSString * const LDBRecoveryManifestTime;  // NSTimeInterval
+extern NSString * const LDBRecoveryLogFiles;      // uint64_t
+extern NSString * const LDBRecoveryLogBytes;      // uint64_t
+extern NSString * const LDBRecoveryLogRecords;    // uint64_t
+extern NSString * const LDBRecoveryLogTime;       // NSTimeInterval
+extern NSString * const LDBRecoveryFlushTables;   // uint64_t
+extern NSString * const LDBRecoveryFlushBytes;    // uint64_t
+extern NSString * const LDBRecoveryFlushTime;     // NSTimeInterval
 
 #ifdef __cplusplus
 } // extern "C"
@@ -105,6 +118,20 @@ extern NSString * const LDBOptionBloomFilterBits; // NSNumber with integer 0…3
 /// - `LDBOptionCompression`:     `LDBCompression`-valued `NSNumber`, default 1
 /// - `LDBOptionReuseLogs`:       `BOOL`-valued `NSNumber`, default `NO` for now
 /// - `LDBOptionBloomFilterBits`: `int`-valued `NSNumber` 0...32, default 0
+/// - `LDBOptionLogSizeLimit`:    `size_t`-valued `NSNumber`, default 0
+///
+/// When `LDBOptionLogSizeLimit` is non-zero, the memtable is flushed into a
+/// table file as soon as the live write-ahead log grows past the limit, which
+/// bounds the amount of log the next open has to replay. The check is made
+/// right after opening (which matters with `LDBOptionReuseLogs`, where the
+/// last log is kept across restarts) and after every write through `self`.
+///
+/// The write which crosses the limit makes LevelDB switch to a new log file and
+/// memtable, and the old memtable is flushed by the background thread. That
+/// write only blocks where any LevelDB write would: until the previous memtable
+/// is flushed, or while level 0 has too many files. Concurrent writes crossing
+/// the limit switch the log only once. Closing the database before the flush
+/// finishes leaves the old log to be replayed too.
 ///
 /// Iff there is an error, returns `NO` and sets the `error` pointer with
 /// `LDBErrorMessageKey` set in the `userInfo`.
@@ -217,11 +244,57 @@ extern NSString * const LDBOptionBloomFilterBits; // NSNumber with integer 0…3
 ///   bytes of memory in use by the DB.
 - (NSString *)propertyNamed:(NSString *)name;
 
+/// The breakdown of where the time went when opening the database, with the
+/// `LDBRecovery*` constants as keys:
+///
+/// - `LDBRecoveryTotalTime`: seconds spent in opening the database in total
+/// - `LDBRecoveryManifestBytes`, `LDBRecoveryManifestTime`: bytes of the
+///   descriptor (`MANIFEST-*`) file read, and the seconds spent reading it
+/// - `LDBRecoveryLogFiles`, `LDBRecoveryLogBytes`, `LDBRecoveryLogRecords`,
+///   `LDBRecoveryLogTime`: the number of write-ahead log files replayed into
+///   the memtable, their total bytes and write batch records, and the seconds
+///   spent replaying them (excluding the flushes made in between)
+/// - `LDBRecoveryFlushTables`, `LDBRecoveryFlushBytes`, `LDBRecoveryFlushTime`:
+///   the number and total bytes of level-0 tables written from the recovered
+///   memtable, and the seconds spent writing them
+///
+/// Every key is present for databases opened with
+/// `-[LDBDatabase initWithPath:options:error:]`, and the dictionary is empty
+/// for in-memory databases.
+@property (nonatomic, readonly, copy) NSDictionary <NSString *, NSNumber *> *recoveryStatistics;
+
 /// Retrieve as an `NSArray` of `NSNumber`s the approximate file system space
 /// used by the keys `intervals[i].start ..< intervals[i].end` where `intervals`
 /// is an array of `LDBInterval`s.
 - (NSArray <NSNumber *> *)approximateSizesForIntervals:(NSArray <LDBInterval *> *)intervals;
 
+/// Retrieve as an `NSArray` of `NSNumber`s the approximate number of entries
+/// with keys `intervals[i].start ..< intervals[i].end` where `intervals` is an
+/// array of `LDBInterval`s.
+///
+/// The estimates are made from the index blocks of the table files without
+/// scanning the data, and the index of each table file is only read once.
+/// Like with `-[LDBDatabase approximateSizesForIntervals:]`, recent writes not
+/// yet flushed from the memtable are not counted. Overwritten and deleted keys
+/// may be counted until compacted away.
+///
+/// Only the first, middle and last data blocks of each table are counted, and
+/// the other blocks are assumed to hold as many entries per (compressed) byte
+/// as those. Tables whose entry sizes or compressibility vary from block to
+/// block are therefore estimated less accurately. Within a table, the entries
+/// of the blocks at the ends of each interval are counted as half.
+- (NSArray <NSNumber *> *)approximateCountsForIntervals:(NSArray <LDBInterval *> *)intervals;
+
+/// Retrieve in increasing order up to `count - 1` keys within `interval` which
+/// approximately split it into `count` parts with an equal number of entries,
+/// e.g. for dividing work between parallel jobs. The keys need not exist in the
+/// database. Fewer keys are returned when the interval is too small to split.
+///
+/// **See also:** `-[LDBDatabase approximateCountsForIntervals:]`
+- (NSArray <NSData *> *)
+    approximateSplitKeysForInterval:(LDBInterval *)interval
+    count:(NSUInteger)count;
+
 /// Compact the underlying storage for the key range `interval`. In particular,
 /// deleted and overwritten versions are discarded, and the data is rearranged
 /// to reduce the cost of operations needed to access the data. This operation
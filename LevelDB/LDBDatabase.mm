@@ -15,12 +15,26 @@
 
 #include <libkern/OSAtomic.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <map>
 #include <memory>
+#include <mutex>
+#include <sstream>
+#include <vector>
+#include "db/dbformat.h"
+#include "db/filename.h"
+#include "db/log_format.h"
 #include "helpers/memenv/memenv.h"
 #include "leveldb/cache.h"
+#include "leveldb/comparator.h"
 #include "leveldb/db.h"
 #include "leveldb/env.h"
 #include "leveldb/filter_policy.h"
+#include "table/block.h"
+#include "table/format.h"
 
 // -----------------------------------------------------------------------------
 #pragma mark - Constants
@@ -38,6 +52,477 @@ NSString * const LDBOptionBlockRestartInterval = @"LDBOptionBlockRestartInterval
 NSString * const LDBOptionCompression          = @"LDBOptionCompression";
 NSString * const LDBOptionReuseLogs            = @"LDBOptionReuseLogs";
 NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
+NSString * const LDBOptionLogSizeLimit         = @"LDBOptionLogSizeLimit";
+
+NSString * const LDBRecoveryTotalTime          = @"LDBRecoveryTotalTime";
+NSString * const LDBRecoveryManifestBytes      = @"LDBRecoveryManifestBytes";
+NSString * const LDBRecoveryManifestTime       = @"LDBRecoveryManifestTime";
+NSString * const LDBRecoveryLogFiles           = @"LDBRecoveryLogFiles";
+NSString * const LDBRecoveryLogBytes           = @"LDBRecoveryLogBytes";
+NSString * const LDBRecoveryLogRecords         = @"LDBRecoveryLogRecords";
+NSString * const LDBRecoveryLogTime            = @"LDBRecoveryLogTime";
+NSString * const LDBRecoveryFlushTables        = @"LDBRecoveryFlushTables";
+NSString * const LDBRecoveryFlushBytes         = @"LDBRecoveryFlushBytes";
+NSString * const LDBRecoveryFlushTime          = @"LDBRecoveryFlushTime";
+
+
+// -----------------------------------------------------------------------------
+#pragma mark - Recovery instrumentation
+
+namespace leveldb_objc {
+
+using steady_clock_t = std::chrono::steady_clock;
+
+static double seconds_since(steady_clock_t::time_point start) {
+    return std::chrono::duration<double>(steady_clock_t::now() - start).count();
+}
+
+struct recovery_stats_t {
+    double   manifest_seconds = 0;
+    uint64_t manifest_bytes   = 0;
+    uint64_t log_files        = 0;
+    uint64_t log_bytes        = 0;
+    uint64_t log_records      = 0;
+    double   log_seconds      = 0;
+    uint64_t flush_tables     = 0;
+    uint64_t flush_bytes      = 0;
+    double   flush_seconds    = 0;
+};
+
+/// Env which measures the files LevelDB reads and writes while recovering in
+/// `DB::Open`, and afterwards keeps track of the size of the live log file and
+/// the number of files deleted.
+///
+/// Recovery is over as soon as LevelDB opens a log file for writing, which it
+/// does after replaying (and possibly flushing) the old logs. Until then, all
+/// file access happens on the thread calling `DB::Open`, so `stats` needs no
+/// locking.
+struct recovery_env_t final : leveldb::EnvWrapper {
+
+    recovery_stats_t stats;
+
+    explicit recovery_env_t(leveldb::Env *target) : EnvWrapper(target) {}
+
+    bool is_recovering() const { return _recovering; }
+    uint64_t live_log_bytes() const { return _live_log_bytes; }
+
+    /// The number of files deleted so far. LevelDB deletes obsolete files
+    /// right after installing each new version, so the set of live table files
+    /// only changes (for longer than a moment) when this does.
+    uint64_t deleted_files() const { return _deleted_files; }
+
+    /// Claim the right to switch to a new log, or return `false` if another
+    /// thread is already doing so. Call `end_log_switch` when done.
+    bool begin_log_switch() {
+        auto expected = false;
+        return _switching_log.compare_exchange_strong(expected, true);
+    }
+    void end_log_switch() { _switching_log = false; }
+
+    virtual leveldb::Status NewSequentialFile(std::string const &fname,
+                                              leveldb::SequentialFile **result) override
+    {
+        auto status = target()->NewSequentialFile(fname, result);
+        auto type = file_type(fname);
+        if (status.ok() && _recovering && type == leveldb::kDescriptorFile) {
+            *result = new manifest_reader_t(this, *result);
+        } else if (status.ok() && _recovering && type == leveldb::kLogFile) {
+            *result = new log_reader_t(this, *result);
+        }
+        return status;
+    }
+
+    virtual leveldb::Status NewWritableFile(std::string const &fname,
+                                            leveldb::WritableFile **result) override
+    {
+        auto status = target()->NewWritableFile(fname, result);
+        auto type = file_type(fname);
+        if (status.ok() && type == leveldb::kLogFile) {
+            _recovering = false;
+            _live_log_bytes = 0;
+            *result = new log_writer_t(this, *result);
+        } else if (status.ok() && _recovering && type == leveldb::kTableFile) {
+            *result = new table_writer_t(this, *result);
+        }
+        return status;
+    }
+
+    virtual leveldb::Status DeleteFile(std::string const &fname) override
+    {
+        auto status = target()->DeleteFile(fname);
+        _deleted_files++;
+        return status;
+    }
+
+    virtual leveldb::Status NewAppendableFile(std::string const &fname,
+                                              leveldb::WritableFile **result) override
+    {
+        auto status = target()->NewAppendableFile(fname, result);
+        if (status.ok() && file_type(fname) == leveldb::kLogFile) {
+            uint64_t size = 0;
+            target()->GetFileSize(fname, &size);
+            _recovering = false;
+            _live_log_bytes = size;
+            *result = new log_writer_t(this, *result);
+        }
+        return status;
+    }
+
+private:
+
+    std::atomic<bool>     _recovering{true};
+    std::atomic<uint64_t> _live_log_bytes{0};
+    std::atomic<bool>     _switching_log{false};
+    std::atomic<uint64_t> _deleted_files{0};
+
+    static leveldb::FileType file_type(std::string const &fname) {
+        auto slash = fname.rfind('/');
+        auto base = slash == std::string::npos ? fname : fname.substr(slash + 1);
+        uint64_t number = 0;
+        auto type = leveldb::kTempFile;
+        return leveldb::ParseFileName(base, &number, &type) ? type : leveldb::kTempFile;
+    }
+
+    struct manifest_reader_t final : leveldb::SequentialFile {
+        recovery_env_t *env;
+        std::unique_ptr<leveldb::SequentialFile> file;
+        steady_clock_t::time_point start = steady_clock_t::now();
+
+        manifest_reader_t(recovery_env_t *env, leveldb::SequentialFile *file)
+            : env(env), file(file) {}
+
+        ~manifest_reader_t() {
+            env->stats.manifest_seconds += seconds_since(start);
+        }
+
+        virtual leveldb::Status Read(size_t n, leveldb::Slice *result, char *scratch) override {
+            auto status = file->Read(n, result, scratch);
+            if (status.ok()) env->stats.manifest_bytes += result->size();
+            return status;
+        }
+
+        virtual leveldb::Status Skip(uint64_t n) override {
+            return file->Skip(n);
+        }
+    };
+
+    /// Counts the write batch records of the log by following the physical
+    /// record headers (see "db/log_format.h") as the bytes are read. Time
+    /// spent flushing the memtable in between is not counted as replay time.
+    struct log_reader_t final : leveldb::SequentialFile {
+        recovery_env_t *env;
+        std::unique_ptr<leveldb::SequentialFile> file;
+        steady_clock_t::time_point start = steady_clock_t::now();
+        double flush_seconds_at_start;
+        uint64_t offset = 0;
+        uint64_t skip = 0;
+        size_t header_size = 0;
+        unsigned char header[leveldb::log::kHeaderSize];
+
+        log_reader_t(recovery_env_t *env, leveldb::SequentialFile *file)
+            : env(env), file(file)
+            , flush_seconds_at_start(env->stats.flush_seconds)
+        {
+            env->stats.log_files++;
+        }
+
+        ~log_reader_t() {
+            auto flushing = env->stats.flush_seconds - flush_seconds_at_start;
+            env->stats.log_seconds += seconds_since(start) - flushing;
+        }
+
+        virtual leveldb::Status Read(size_t n, leveldb::Slice *result, char *scratch) override {
+            auto status = file->Read(n, result, scratch);
+            if (status.ok()) {
+                env->stats.log_bytes += result->size();
+                consume(reinterpret_cast<unsigned char const *>(result->data()),
+                        result->size());
+            }
+            return status;
+        }
+
+        virtual leveldb::Status Skip(uint64_t n) override {
+            // Resynchronise with the record headers at the next block.
+            offset += n;
+            header_size = 0;
+            skip = remaining_in_block();
+            return file->Skip(n);
+        }
+
+    private:
+
+        uint64_t remaining_in_block() const {
+            auto used = offset % leveldb::log::kBlockSize;
+            return used ? leveldb::log::kBlockSize - used : 0;
+        }
+
+        void consume(unsigned char const *p, size_t n) {
+            namespace log = leveldb::log;
+            while (n) {
+                if (skip) {
+                    auto k = static_cast<size_t>(std::min<uint64_t>(skip, n));
+                    skip -= k, offset += k, p += k, n -= k;
+                    continue;
+                }
+                if (!header_size && offset % log::kBlockSize > log::kBlockSize - log::kHeaderSize) {
+                    skip = remaining_in_block(); // block trailer
+                    continue;
+                }
+                header[header_size++] = *p;
+                offset++, p++, n--;
+                if (header_size < log::kHeaderSize) continue;
+                header_size = 0;
+                auto const length = header[4] | header[5] << 8;
+                auto const type = header[6];
+                if (type == log::kFullType || type == log::kFirstType) {
+                    env->stats.log_records++;
+                }
+                skip = type == log::kZeroType && !length ? remaining_in_block()
+                                                         : length;
+            }
+        }
+    };
+
+    struct table_writer_t final : leveldb::WritableFile {
+        recovery_env_t *env;
+        std::unique_ptr<leveldb::WritableFile> file;
+        steady_clock_t::time_point start = steady_clock_t::now();
+
+        table_writer_t(recovery_env_t *env, leveldb::WritableFile *file)
+            : env(env), file(file)
+        {
+            env->stats.flush_tables++;
+        }
+
+        ~table_writer_t() {
+            file.reset();
+            env->stats.flush_seconds += seconds_since(start);
+        }
+
+        virtual leveldb::Status Append(leveldb::Slice const &data) override {
+            auto status = file->Append(data);
+            if (status.ok()) env->stats.flush_bytes += data.size();
+            return status;
+        }
+
+        virtual leveldb::Status Close() override { return file->Close(); }
+        virtual leveldb::Status Flush() override { return file->Flush(); }
+        virtual leveldb::Status Sync()  override { return file->Sync(); }
+    };
+
+    struct log_writer_t final : leveldb::WritableFile {
+        recovery_env_t *env;
+        std::unique_ptr<leveldb::WritableFile> file;
+
+        log_writer_t(recovery_env_t *env, leveldb::WritableFile *file)
+            : env(env), file(file) {}
+
+        virtual leveldb::Status Append(leveldb::Slice const &data) override {
+            auto status = file->Append(data);
+            if (status.ok()) env->_live_log_bytes += data.size();
+            return status;
+        }
+
+        virtual leveldb::Status Close() override { return file->Close(); }
+        virtual leveldb::Status Flush() override { return file->Flush(); }
+        virtual leveldb::Status Sync()  override { return file->Sync(); }
+    };
+};
+
+} // namespace leveldb_objc
+
+
+// -----------------------------------------------------------------------------
+#pragma mark - Table statistics
+
+namespace leveldb_objc {
+
+/// Summary of a table file as read from its index block: the smallest and
+/// largest user key in the table, and for each run of consecutive data blocks
+/// the user key of the last index entry, bounding the keys of the run from
+/// above, and the estimated number of entries in the run.
+///
+/// The first, middle and last data blocks are counted exactly, and the entries
+/// of the other blocks extrapolated from the (compressed) bytes per entry in
+/// those three. Tables of more than `max_runs` blocks have their blocks merged
+/// into runs, which bounds the memory taken by the summaries.
+struct table_summary_t {
+    static size_t const max_runs = 256;
+    std::string              smallest;
+    std::string              largest;
+    std::vector<std::string> limits;
+    std::vector<double>      entries;
+};
+
+using table_summaries_t = std::vector<std::shared_ptr<table_summary_t const>>;
+
+/// Cache of `table_summary_t`s by table file number, and of the live tables as
+/// of the `deleted_files` count of `recovery_env_t`. Table files are immutable,
+/// so the summaries only have to be dropped once the files are.
+struct table_stats_t {
+    using map_t = std::map<uint64_t, std::shared_ptr<table_summary_t const>>;
+    std::mutex mutex;
+    map_t tables;
+    table_summaries_t live;
+    uint64_t deleted_files = 0;
+    bool is_current = false;
+};
+
+/// Count the entries of the data block at `handle`, and set the user keys of
+/// its first and last entries into `first` and `last` if non-null.
+static leveldb::Status count_block(leveldb::RandomAccessFile *file,
+                                   leveldb::BlockHandle const &handle,
+                                   leveldb::Comparator const *comparator,
+                                   double *count,
+                                   std::string *first,
+                                   std::string *last)
+{
+    using namespace leveldb;
+    BlockContents contents;
+    auto status = ReadBlock(file, ReadOptions{}, handle, &contents);
+    if (!status.ok()) return status;
+    Block block(contents);
+    auto iter = std::unique_ptr<Iterator>(block.NewIterator(comparator));
+    *count = 0;
+    for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+        if (first && *count == 0) *first = ExtractUserKey(iter->key()).ToString();
+        if (last) *last = ExtractUserKey(iter->key()).ToString();
+        ++*count;
+    }
+    return iter->status();
+}
+
+static leveldb::Status read_table_summary(leveldb::Env *env,
+                                          std::string const &fname,
+                                          table_summary_t *summary)
+{
+    using namespace leveldb;
+    uint64_t size = 0;
+    auto status = env->GetFileSize(fname, &size);
+    if (!status.ok()) return status;
+    if (size < Footer::kEncodedLength) {
+        return Status::Corruption("file is too short to be an sstable", fname);
+    }
+    
+    RandomAccessFile *raw_file = nullptr;
+    status = env->NewRandomAccessFile(fname, &raw_file);
+    if (!status.ok()) return status;
+    auto file = std::unique_ptr<RandomAccessFile>(raw_file);
+    
+    char footer_space[Footer::kEncodedLength];
+    Slice footer_input;
+    status = file->Read(size - Footer::kEncodedLength, Footer::kEncodedLength,
+                        &footer_input, footer_space);
+    if (!status.ok()) return status;
+    Footer footer;
+    status = footer.DecodeFrom(&footer_input);
+    if (!status.ok()) return status;
+
+    InternalKeyComparator const comparator(BytewiseComparator());
+    BlockContents index_contents;
+    status = ReadBlock(file.get(), ReadOptions{}, footer.index_handle(), &index_contents);
+    if (!status.ok()) return status;
+    Block index(index_contents);
+    auto index_iter = std::unique_ptr<Iterator>(index.NewIterator(&comparator));
+    
+    std::vector<std::string> limits;
+    std::vector<BlockHandle> handles;
+    for (index_iter->SeekToFirst(); index_iter->Valid(); index_iter->Next()) {
+        auto handle = BlockHandle{};
+        auto input = index_iter->value();
+        status = handle.DecodeFrom(&input);
+        if (!status.ok()) return status;
+        if (index_iter->key().size() < 8) {
+            return Status::Corruption("bad index entry key", fname);
+        }
+        limits.push_back(ExtractUserKey(index_iter->key()).ToString());
+        handles.push_back(handle);
+    }
+    if (!index_iter->status().ok()) return index_iter->status();
+    if (handles.empty()) return status;
+    
+    auto const n = handles.size();
+    std::vector<double> entries(n, -1);
+    double sampled_entries = 0;
+    double sampled_bytes = 0;
+    for (auto i : {size_t(0), n / 2, n - 1}) {
+        if (entries[i] >= 0) continue;
+        status = count_block(file.get(), handles[i], &comparator, &entries[i],
+                             i == 0     ? &summary->smallest : nullptr,
+                             i == n - 1 ? &summary->largest  : nullptr);
+        if (!status.ok()) return status;
+        sampled_entries += entries[i];
+        sampled_bytes += handles[i].size();
+    }
+    
+    auto const entries_per_byte = sampled_entries / std::max(sampled_bytes, 1.0);
+    auto const run_length = (n + table_summary_t::max_runs - 1) / table_summary_t::max_runs;
+    for (size_t i = 0; i < n; ++i) {
+        auto const count = entries[i] >= 0 ? entries[i]
+                         : std::max(1.0, entries_per_byte * handles[i].size());
+        if (i % run_length == 0) {
+            summary->entries.push_back(0);
+        }
+        summary->entries.back() += count;
+        if (i % run_length == run_length - 1 || i == n - 1) {
+            summary->limits.push_back(std::move(limits[i]));
+        }
+    }
+    return status;
+}
+
+/// Parse the numbers of the live table files out of the `"leveldb.sstables"`
+/// property, whose lines look like `" 12:34567['a' @ 8 : 1 .. 'z' @ 9 : 1]"`.
+static std::vector<uint64_t> live_table_numbers(leveldb::DB *db)
+{
+    std::vector<uint64_t> numbers;
+    std::string sstables;
+    if (!db->GetProperty("leveldb.sstables", &sstables)) return numbers;
+    std::istringstream lines(sstables);
+    for (std::string line; std::getline(lines, line);) {
+        unsigned long long number = 0, size = 0;
+        if (std::sscanf(line.c_str(), " %llu:%llu[", &number, &size) == 2) {
+            numbers.push_back(number);
+        }
+    }
+    return numbers;
+}
+
+/// Call `f(limit, entries)` for each run of data blocks in `tables` overlapping
+/// the `interval`, counting half of the entries of the runs only partially
+/// within the `interval`.
+template <typename F>
+static void for_each_block(table_summaries_t const &tables,
+                           LDBInterval *interval,
+                           F f)
+{
+    if (interval.isEmpty) return;
+    NSData *end = interval.end;
+    auto const start_slice = to_Slice(interval.start);
+    auto const end_slice = to_Slice(end);
+    auto const before_end = [&](leveldb::Slice const &key) {
+        return !end || key.compare(end_slice) < 0;
+    };
+    auto const before_start = [](std::string const &key, leveldb::Slice const &start) {
+        return leveldb::Slice(key).compare(start) < 0;
+    };
+    for (auto const &table : tables) {
+        auto const &limits = table->limits;
+        if (limits.empty()) continue;
+        if (before_start(table->largest, start_slice)) continue;
+        if (!before_end(table->smallest)) continue;
+        auto const first = std::lower_bound(limits.begin(), limits.end(), start_slice, before_start);
+        for (auto i = static_cast<size_t>(first - limits.begin()); i < limits.size(); ++i) {
+            auto const lower = leveldb::Slice(i ? limits[i - 1] : table->smallest);
+            auto const upper = leveldb::Slice(i + 1 < limits.size() ? limits[i] : table->largest);
+            if (!before_end(lower)) break;
+            auto const inside = lower.compare(start_slice) >= 0 && before_end(upper);
+            f(limits[i], inside ? table->entries[i] : table->entries[i] / 2);
+        }
+    }
+}
+
+} // namespace leveldb_objc
 
 
 // -----------------------------------------------------------------------------
@@ -45,6 +530,10 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
 
 @interface LDBDatabase () {
     std::unique_ptr<leveldb::Env>                 _env;
+    std::unique_ptr<leveldb_objc::recovery_env_t> _recovery_env;
+    size_t                                        _logSizeLimit;
+    std::string                                   _name;
+    leveldb_objc::table_stats_t                   _table_stats;
     LDBLogger                                    *_logger;
     std::unique_ptr<leveldb::FilterPolicy const>  _filter_policy;
     std::unique_ptr<leveldb::Cache>               _cache;
@@ -79,10 +568,12 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
         return nil;
     }
     
+    _recoveryStatistics = @{};
     _env = std::unique_ptr<leveldb::Env>(
         leveldb::NewMemEnv(leveldb::Env::Default()));
+    _recovery_env.reset(new leveldb_objc::recovery_env_t(_env.get()));
     auto options = leveldb::Options{};
-    options.env = _env.get();
+    options.env = _recovery_env.get();
     options.create_if_missing = true;
 
     static std::int64_t counter = 0;
@@ -95,6 +586,8 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
         return nil;
     }
 
+    _name = name;
+
     _db = std::unique_ptr<leveldb::DB>(db);
 
     return self;
@@ -122,9 +615,15 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
     
     auto options = leveldb::Options{};
     [self _readOptions:options optionsDictionary:optionsDictionary];
+    _recovery_env.reset(new leveldb_objc::recovery_env_t(options.env));
+    options.env = _recovery_env.get();
+    
+    auto start = leveldb_objc::steady_clock_t::now();
     leveldb::DB *db = nullptr;
-    auto status = leveldb::DB::Open(options, path.UTF8String, &db);
+    _name = path.UTF8String;
+    auto status = leveldb::DB::Open(options, _name, &db);
     _db.reset(db);
+    [self _setRecoveryStatistics:leveldb_objc::seconds_since(start)];
 
     if (!status.ok()) {
         if (error) {
@@ -132,6 +631,7 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
         }
         return nil;
     } else {
+        [self _limitLogSize];
         return self;
     }
 }
@@ -169,16 +669,13 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
         return NO;
     }
 
-    if (data) {
-        auto status = _db->Put(leveldb::WriteOptions{},
-                               leveldb_objc::to_Slice(key),
-                               leveldb_objc::to_Slice(data));
-        return status.ok();
-    } else {
-        auto status = _db->Delete(leveldb::WriteOptions{},
-                                  leveldb_objc::to_Slice(key));
-        return status.ok();
-    }
+    auto status = data ? _db->Put(leveldb::WriteOptions{},
+                                  leveldb_objc::to_Slice(key),
+                                  leveldb_objc::to_Slice(data))
+                       : _db->Delete(leveldb::WriteOptions{},
+                                     leveldb_objc::to_Slice(key));
+    [self _limitLogSize];
+    return status.ok();
 }
 
 - (BOOL)setObject:(NSData *)data forKeyedSubscript:(NSData *)key
@@ -199,6 +696,7 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
     auto writeOptions = leveldb::WriteOptions{};
     writeOptions.sync = sync;
     auto status = _db->Write(writeOptions, batch.private_batch);
+    [self _limitLogSize];
     return leveldb_objc::objc_result(status, error);
 }
 
@@ -233,6 +731,54 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
     return [result copy];
 }
 
+- (NSArray <NSNumber *> *)approximateCountsForIntervals:(NSArray <LDBInterval *> *)intervals
+{
+    auto const tables = [self _tableSummaries];
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:intervals.count];
+    for (LDBInterval *interval in intervals) {
+        NSParameterAssert([interval isKindOfClass:LDBInterval.class]);
+        double count = 0;
+        leveldb_objc::for_each_block(tables, interval, [&](std::string const &, double entries) {
+            count += entries;
+        });
+        [result addObject:@(static_cast<uint64_t>(count + 0.5))];
+    }
+    return [result copy];
+}
+
+- (NSArray <NSData *> *)
+    approximateSplitKeysForInterval:(LDBInterval *)interval
+    count:(NSUInteger)count
+{
+    NSParameterAssert([interval isKindOfClass:LDBInterval.class]);
+    if (count < 2) return @[];
+    
+    std::vector<std::pair<std::string, double>> blocks;
+    double total = 0;
+    leveldb_objc::for_each_block([self _tableSummaries], interval, [&](std::string const &limit, double entries) {
+        blocks.emplace_back(limit, entries);
+        total += entries;
+    });
+    std::sort(blocks.begin(), blocks.end());
+    
+    NSMutableArray *result = [NSMutableArray arrayWithCapacity:count - 1];
+    NSData *previous = interval.start;
+    double cumulative = 0;
+    NSUInteger part = 1;
+    for (auto const &block : blocks) {
+        if (part == count) break;
+        cumulative += block.second;
+        if (cumulative < total * part / count) continue;
+        while (part < count && cumulative >= total * part / count) part++;
+        NSData *key = leveldb_objc::to_NSData(block.first);
+        if (leveldb_objc::compare(previous, key) < 0 && [interval contains:key]) {
+            [result addObject:key];
+            previous = key;
+        }
+    }
+    return [result copy];
+}
+
 - (void)compactInterval:(LDBInterval *)interval
 {
     if (leveldb_objc::compare(interval.start, interval.end) >= 0) return;
@@ -256,6 +802,91 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
 // -----------------------------------------------------------------------------
 #pragma mark - Private parts
 
+/// Copy the statistics collected by `_recovery_env` during `DB::Open` into
+/// `recoveryStatistics`, along with the `totalTime` of opening.
+- (void)_setRecoveryStatistics:(NSTimeInterval)totalTime
+{
+    auto const &stats = _recovery_env->stats;
+    _recoveryStatistics = @{
+        LDBRecoveryTotalTime:     @(totalTime),
+        LDBRecoveryManifestBytes: @(stats.manifest_bytes),
+        LDBRecoveryManifestTime:  @(stats.manifest_seconds),
+        LDBRecoveryLogFiles:      @(stats.log_files),
+        LDBRecoveryLogBytes:      @(stats.log_bytes),
+        LDBRecoveryLogRecords:    @(stats.log_records),
+        LDBRecoveryLogTime:       @(stats.log_seconds),
+        LDBRecoveryFlushTables:   @(stats.flush_tables),
+        LDBRecoveryFlushBytes:    @(stats.flush_bytes),
+        LDBRecoveryFlushTime:     @(stats.flush_seconds)
+    };
+}
+
+/// The `Env` the database files are accessed through.
+- (leveldb::Env *)_fileEnv
+{
+    if (_recovery_env) return _recovery_env.get();
+    if (_env) return _env.get();
+    return leveldb::Env::Default();
+}
+
+/// Summaries of the live table files, reading the index blocks of the tables
+/// not seen before. Tables that fail to be read are skipped.
+///
+/// The live tables are only listed again after `_recovery_env` has seen files
+/// deleted, because formatting the `"leveldb.sstables"` property is costly.
+- (leveldb_objc::table_summaries_t)_tableSummaries
+{
+    namespace ldb = leveldb_objc;
+    auto const deleted_files = _recovery_env->deleted_files();
+    
+    std::lock_guard<std::mutex> lock(_table_stats.mutex);
+    if (_table_stats.is_current && _table_stats.deleted_files == deleted_files) {
+        return _table_stats.live;
+    }
+    
+    auto &tables = _table_stats.tables;
+    auto live = ldb::table_stats_t::map_t{};
+    ldb::table_summaries_t result;
+    for (auto number : ldb::live_table_numbers(_db.get())) {
+        auto found = tables.find(number);
+        if (found == tables.end()) {
+            auto summary = std::make_shared<ldb::table_summary_t>();
+            auto env = [self _fileEnv];
+            auto status = ldb::read_table_summary(env, leveldb::TableFileName(_name, number), summary.get());
+            if (!status.ok()) {
+                summary = std::make_shared<ldb::table_summary_t>();
+                status = ldb::read_table_summary(env, leveldb::SSTTableFileName(_name, number), summary.get());
+            }
+            if (!status.ok()) continue;
+            found = tables.emplace(number, summary).first;
+        }
+        live.insert(*found);
+        result.push_back(found->second);
+    }
+    tables.swap(live);
+    _table_stats.live = result;
+    _table_stats.deleted_files = deleted_files;
+    _table_stats.is_current = true;
+    return result;
+}
+
+/// Switch to a new log if the live log has grown past `LDBOptionLogSizeLimit`.
+///
+/// There is no public LevelDB API for flushing the memtable, but `DB::Write`
+/// with a null batch (as used by `DBImpl::TEST_CompactMemTable`) forces a new
+/// log and memtable, and leaves the flush of the old one to the background
+/// thread without waiting for it.
+- (void)_limitLogSize
+{
+    if (!_logSizeLimit || !_recovery_env) return;
+    if (_recovery_env->live_log_bytes() <= _logSizeLimit) return;
+    if (!_recovery_env->begin_log_switch()) return;
+    if (_recovery_env->live_log_bytes() > _logSizeLimit) {
+        _db->Write(leveldb::WriteOptions{}, nullptr);
+    }
+    _recovery_env->end_log_switch();
+}
+
 /// Parse database options and set `_logger`, `_filter_policy` and `_cache` if
 /// needed.
 - (void)
@@ -314,6 +945,7 @@ NSString * const LDBOptionBloomFilterBits      = @"LDBOptionBloomFilterBits";
     parse_int(LDBOptionBlockRestartInterval, opts.block_restart_interval);
     parse_size_t(LDBOptionWriteBufferSize, opts.write_buffer_size);
     parse_size_t(LDBOptionBlockSize, opts.block_size);
+    parse_size_t(LDBOptionLogSizeLimit, _logSizeLimit);
     
     // info log
     parse(LDBOptionInfoLog, ^(id value, NSString **error) {
@@ -35,6 +35,22 @@
 /// otherwise.
 @property (nonatomic, readonly, copy) NSData * __nullable value;
 
+/// Pointer to the bytes of the current key if `self.isValid`, `NULL`
+/// otherwise. Unlike `self.key`, the bytes are not copied, and they only stay
+/// valid until the enumerator is stepped or deallocated.
+@property (nonatomic, readonly) void const * __nullable keyBytes;
+
+/// The number of bytes at `self.keyBytes`.
+@property (nonatomic, readonly) NSUInteger keyLength;
+
+/// Pointer to the bytes of the current value if `self.isValid`, `NULL`
+/// otherwise. Unlike `self.value`, the bytes are not copied, and they only stay
+/// valid until the enumerator is stepped or deallocated.
+@property (nonatomic, readonly) void const * __nullable valueBytes;
+
+/// The number of bytes at `self.valueBytes`.
+@property (nonatomic, readonly) NSUInteger valueLength;
+
 /// If the enumerator is still valid, move to the next position, possibly
 /// invalidating the enumerator. Otherwise a no-op.
 - (void)step;
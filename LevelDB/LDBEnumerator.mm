@@ -19,6 +19,8 @@
     NSUInteger _prefixLength;
     NSData *_start;
     NSData *_end;
+    BOOL _valid;
+    NSData *_key;
     NSData *_value;
 }
 @end
@@ -78,17 +80,45 @@
 
 - (BOOL)isValid
 {
-    return self.key != nil;
+    return _valid;
+}
+
+- (NSData *)key
+{
+    if (!_key && _valid) {
+        _key = [NSData dataWithBytes:self.keyBytes length:self.keyLength];
+    }
+    return _key;
 }
 
 - (NSData *)value
 {
-    if (!_value && self.key) {
+    if (!_value && _valid) {
         _value = leveldb_objc::to_NSData(_impl->value());
     }
     return _value;
 }
 
+- (void const *)keyBytes
+{
+    return _valid ? _impl->key().data() + _prefixLength : NULL;
+}
+
+- (NSUInteger)keyLength
+{
+    return _valid ? _impl->key().size() - _prefixLength : 0;
+}
+
+- (void const *)valueBytes
+{
+    return _valid ? _impl->value().data() : NULL;
+}
+
+- (NSUInteger)valueLength
+{
+    return _valid ? _impl->value().size() : 0;
+}
+
 - (void)step
 {
     if (!self.snapshot.isReversed) {
@@ -111,43 +141,43 @@
 
 - (void)private_stepForward
 {
-    namespace ldb = leveldb_objc;
     if (!self.isValid) return;
     _impl->Next();
     _key = nil;
     _value = nil;
-    if (!_impl->Valid()) return;
-    NSData *key = ldb::to_NSData(_impl->key());
-    if (ldb::compare(key, _end) < 0) {
-        _key = ldb::dropLength(_prefixLength, key);
-    }
+    _valid = _impl->Valid() && [self private_isBeforeEnd:_impl->key()];
 }
 
 - (void)private_stepBackward
 {
-    namespace ldb = leveldb_objc;
     if (!self.isValid) return;
     _impl->Prev();
     _key = nil;
     _value = nil;
-    if (!_impl->Valid()) return;
-    NSData *key = ldb::to_NSData(_impl->key());
-    if (ldb::compare(_start, key) <= 0) {
-        _key = ldb::dropLength(_prefixLength, key);
-    }
+    _valid = _impl->Valid() && [self private_isFromStart:_impl->key()];
 }
 
 - (void)private_update
 {
-    namespace ldb = leveldb_objc;
     _key = nil;
     _value = nil;
-    if (!_impl->Valid()) return;
-    
-    NSData *key = ldb::to_NSData(_impl->key());
-    if (ldb::compare(_start, key) <= 0 && ldb::compare(key, _end) < 0) {
-        _key = ldb::dropLength(_prefixLength, key);
-    }
+    _valid = _impl->Valid()
+          && [self private_isFromStart:_impl->key()]
+          && [self private_isBeforeEnd:_impl->key()];
+}
+
+/// Test `_start <= key` without copying `key`. A `nil` `_start` compares
+/// greater than any key.
+- (BOOL)private_isFromStart:(leveldb::Slice const &)key
+{
+    return _start && leveldb_objc::to_Slice(_start).compare(key) <= 0;
+}
+
+/// Test `key < _end` without copying `key`. A `nil` `_end` compares greater
+/// than any key.
+- (BOOL)private_isBeforeEnd:(leveldb::Slice const &)key
+{
+    return !_end || key.compare(leveldb_objc::to_Slice(_end)) < 0;
 }
 
 @end
@@ -26,6 +26,7 @@ typedef NS_ENUM(NSInteger, LDBError) {
     LDBErrorOk              =  0,
     LDBErrorNotFound        =  1,
     LDBErrorCorruption      =  2,
+    LDBErrorInvalidArgument =  4,
     LDBErrorIOError         =  5,
     LDBErrorOther           = -1
 };
@@ -0,0 +1,145 @@
+//
+//  LDBTuple.h
+//  LevelDB
+//
+//  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
+//
+
+#import <Foundation/Foundation.h>
+
+#pragma clang assume_nonnull begin
+
+@class LDBInterval;
+
+/// Encoder of composite keys such as `(tenant, table, timestamp, id)` into a
+/// single order-preserving byte sequence. Encoded keys compare
+/// lexicographically in the same order as the tuples compare component by
+/// component, provided that the components at each position are of the same
+/// type:
+///
+/// - Fixed-width integers are written in big-endian byte order, the signed ones
+///   offset by the sign bit, exactly like `DataSerializable-Int.swift` does.
+/// - Doubles are written like their `Double.orderPreservingValue`.
+/// - Variable-length bytes and strings (as UTF-8) have each `0x00` byte escaped
+///   as `0x00 0xff`, and are terminated by `0x00 0x01`.
+///
+/// The components are appended into one reusable buffer, so encoding many keys
+/// with the same encoder only allocates the resulting `NSData` objects.
+@interface LDBTupleEncoder : NSObject
+
+/// Create an encoder with a small initial buffer.
+- (instancetype)init;
+
+/// Create an encoder whose buffer fits `capacity` bytes without reallocating.
+- (instancetype)initWithCapacity:(NSUInteger)capacity;
+
+/// The number of bytes encoded so far.
+@property (nonatomic, readonly) NSUInteger length;
+
+/// Copy of the key encoded so far.
+@property (nonatomic, readonly, copy) NSData *data;
+
+/// The interval of keys whose leading components are those encoded so far, for
+/// querying all tuples with a given prefix. E.g. after appending `tenant` and
+/// `table`, contains every `(tenant, table, timestamp, id)`.
+///
+/// To query a range of the component following the prefix, use
+/// `-[LDBTupleEncoder intervalFrom:to:]` instead.
+@property (nonatomic, readonly) LDBInterval *prefixInterval;
+
+/// The interval of keys whose leading components are those encoded so far,
+/// followed by components at least `from` and less than `to`. The blocks
+/// append the bounds, e.g. `^(LDBTupleEncoder *e) { [e appendDouble:t]; }`,
+/// and a `nil` block leaves that end of the range open. E.g. after appending
+/// `tenant` and `table`, can contain every `(tenant, table, timestamp, id)`
+/// with `t0 <= timestamp < t1`.
+///
+/// Both bounds are encoded in the buffer of `self`, which is left as it was.
+- (LDBInterval *)
+    intervalFrom:(void (^ __nullable)(LDBTupleEncoder *encoder))from
+    to:(void (^ __nullable)(LDBTupleEncoder *encoder))to;
+
+/// Like `-[LDBTupleEncoder intervalFrom:to:]`, but also containing the keys
+/// whose components continue with those appended by `through`.
+- (LDBInterval *)
+    intervalFrom:(void (^ __nullable)(LDBTupleEncoder *encoder))from
+    through:(void (^ __nullable)(LDBTupleEncoder *encoder))through;
+
+/// Clear the encoded bytes but keep the buffer for encoding another key.
+- (void)reset;
+
+- (void)appendUInt8:(uint8_t)value;
+- (void)appendInt8:(int8_t)value;
+- (void)appendUInt16:(uint16_t)value;
+- (void)appendInt16:(int16_t)value;
+- (void)appendUInt32:(uint32_t)value;
+- (void)appendInt32:(int32_t)value;
+- (void)appendUInt64:(uint64_t)value;
+- (void)appendInt64:(int64_t)value;
+- (void)appendDouble:(double)value;
+
+/// Append the variable-length component of `length` bytes at `bytes`.
+- (void)appendBytes:(void const *)bytes length:(NSUInteger)length;
+
+/// Append the bytes of `data` as a variable-length component.
+- (void)appendData:(NSData *)data;
+
+/// Append the UTF-8 representation of `string` as a variable-length component.
+- (void)appendString:(NSString *)string;
+
+/// Append `data` as is, without escaping or a terminator. Only use this for a
+/// fixed prefix of all keys or for the last component, which then extends to
+/// the end of the key.
+- (void)appendUnescapedData:(NSData *)data;
+
+@end
+
+
+/// Decoder reading the components of a key encoded with `LDBTupleEncoder` in
+/// order. Fixed-width components are read in place, and variable-length ones
+/// can be skipped over as ranges of the key without copying.
+///
+/// A failed decode leaves the decoder where it was.
+@interface LDBTupleDecoder : NSObject
+
+- (instancetype)init __attribute__((unavailable("init not available")));
+
+/// Create a decoder reading the bytes of `data`.
+- (instancetype)initWithData:(NSData *)data;
+
+/// Create a decoder reading the `length` bytes at `bytes` without copying them,
+/// e.g. `enumerator.keyBytes`. The bytes must stay valid while decoding.
+- (instancetype)initWithBytes:(void const *)bytes length:(NSUInteger)length;
+
+/// The position of the next component to decode.
+@property (nonatomic, readonly) NSUInteger offset;
+
+/// Test whether all components have been decoded.
+@property (nonatomic, readonly) BOOL isAtEnd;
+
+- (BOOL)decodeUInt8:(uint8_t *)value;
+- (BOOL)decodeInt8:(int8_t *)value;
+- (BOOL)decodeUInt16:(uint16_t *)value;
+- (BOOL)decodeInt16:(int16_t *)value;
+- (BOOL)decodeUInt32:(uint32_t *)value;
+- (BOOL)decodeInt32:(int32_t *)value;
+- (BOOL)decodeUInt64:(uint64_t *)value;
+- (BOOL)decodeInt64:(int64_t *)value;
+- (BOOL)decodeDouble:(double *)value;
+
+/// Skip over a variable-length component, returning the range of its escaped
+/// bytes (without the terminator) within the key, or `NSNotFound` as the
+/// location if the component is malformed. As long as the component contains
+/// no `0x00` bytes, the range holds the original bytes as they were.
+- (NSRange)decodeBytesRange;
+
+/// Decode a variable-length component, or return `nil` if it is malformed.
+- (NSData * __nullable)decodeData;
+
+/// Decode a variable-length component as UTF-8, or return `nil` if it is
+/// malformed.
+- (NSString * __nullable)decodeString;
+
+@end
+
+#pragma clang assume_nonnull end
@@ -0,0 +1,386 @@
+//
+//  LDBTuple.mm
+//  LevelDB
+//
+//  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
+//
+
+#import "LDBTuple.h"
+
+#import "LDBInterval.h"
+#import "LDBPrivate.hpp"
+
+#include <cmath>
+#include <cstring>
+
+namespace leveldb_objc {
+
+static unsigned char const escaped_zero[] = {0x00, 0xff};
+static unsigned char const terminator[]   = {0x00, 0x01};
+
+static uint64_t const sign_bit = uint64_t(1) << 63;
+
+/// Same mapping as `Double.orderPreservingValue` in Swift: the IEEE 754 bits
+/// of positive numbers get the sign bit set, negative numbers count down from
+/// the sign bit, both zeros map to the sign bit, and NaN to the maximum.
+static uint64_t order_preserving_value(double value)
+{
+    if (std::isnan(value)) return UINT64_MAX;
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof bits);
+    auto const magnitude = bits & ~sign_bit;
+    return (bits & sign_bit) ? sign_bit - magnitude : sign_bit + magnitude;
+}
+
+static double from_order_preserving_value(uint64_t value)
+{
+    auto const bits = value >= sign_bit ? value - sign_bit
+                                        : (sign_bit - value) | sign_bit;
+    double result;
+    std::memcpy(&result, &bits, sizeof result);
+    return result;
+}
+
+static void append_escaped(NSMutableData *buffer, void const *bytes, NSUInteger length)
+{
+    auto p = static_cast<unsigned char const *>(bytes);
+    auto const end = p + length;
+    while (p < end) {
+        auto zero = static_cast<unsigned char const *>(std::memchr(p, 0, end - p));
+        if (!zero) {
+            [buffer appendBytes:p length:end - p];
+            return;
+        }
+        [buffer appendBytes:p length:zero - p];
+        [buffer appendBytes:escaped_zero length:sizeof escaped_zero];
+        p = zero + 1;
+    }
+}
+
+} // namespace leveldb_objc
+
+// -----------------------------------------------------------------------------
+#pragma mark - LDBTupleEncoder
+
+@implementation LDBTupleEncoder {
+    NSMutableData *_buffer;
+}
+
+- (instancetype)init
+{
+    return [self initWithCapacity:64];
+}
+
+- (instancetype)initWithCapacity:(NSUInteger)capacity
+{
+    if (!(self = [super init])) return nil;
+    _buffer = [NSMutableData dataWithCapacity:capacity];
+    return self;
+}
+
+- (NSUInteger)length
+{
+    return _buffer.length;
+}
+
+- (NSData *)data
+{
+    return [_buffer copy];
+}
+
+- (LDBInterval *)prefixInterval
+{
+    NSData *prefix = self.data;
+    return [LDBInterval intervalWithStart:prefix
+                                      end:leveldb_objc::lexicographicalNextSibling(prefix)];
+}
+
+- (LDBInterval *)
+    intervalFrom:(void (^)(LDBTupleEncoder *encoder))from
+    to:(void (^)(LDBTupleEncoder *encoder))to
+{
+    auto const length = _buffer.length;
+    NSData *start = [self private_dataAppending:from];
+    NSData *end = to ? [self private_dataAppending:to]
+                     : leveldb_objc::lexicographicalNextSibling(self.data);
+    _buffer.length = length;
+    return [LDBInterval intervalWithStart:start end:end];
+}
+
+- (LDBInterval *)
+    intervalFrom:(void (^)(LDBTupleEncoder *encoder))from
+    through:(void (^)(LDBTupleEncoder *encoder))through
+{
+    auto const length = _buffer.length;
+    NSData *start = [self private_dataAppending:from];
+    NSData *end = leveldb_objc::lexicographicalNextSibling(
+        through ? [self private_dataAppending:through] : self.data);
+    _buffer.length = length;
+    return [LDBInterval intervalWithStart:start end:end];
+}
+
+/// Copy of the encoded key followed by the components appended by `block`,
+/// which are removed again from the buffer.
+- (NSData *)private_dataAppending:(void (^)(LDBTupleEncoder *encoder))block
+{
+    auto const length = _buffer.length;
+    if (block) block(self);
+    NSData *result = self.data;
+    _buffer.length = length;
+    return result;
+}
+
+- (void)reset
+{
+    _buffer.length = 0;
+}
+
+- (void)appendUInt8:(uint8_t)value
+{
+    [_buffer appendBytes:&value length:sizeof value];
+}
+
+- (void)appendInt8:(int8_t)value
+{
+    [self appendUInt8:static_cast<uint8_t>(value) ^ uint8_t(0x80)];
+}
+
+- (void)appendUInt16:(uint16_t)value
+{
+    uint16_t const bigEndian = CFSwapInt16HostToBig(value);
+    [_buffer appendBytes:&bigEndian length:sizeof bigEndian];
+}
+
+- (void)appendInt16:(int16_t)value
+{
+    [self appendUInt16:static_cast<uint16_t>(value) ^ uint16_t(0x8000)];
+}
+
+- (void)appendUInt32:(uint32_t)value
+{
+    uint32_t const bigEndian = CFSwapInt32HostToBig(value);
+    [_buffer appendBytes:&bigEndian length:sizeof bigEndian];
+}
+
+- (void)appendInt32:(int32_t)value
+{
+    [self appendUInt32:static_cast<uint32_t>(value) ^ (uint32_t(1) << 31)];
+}
+
+- (void)appendUInt64:(uint64_t)value
+{
+    uint64_t const bigEndian = CFSwapInt64HostToBig(value);
+    [_buffer appendBytes:&bigEndian length:sizeof bigEndian];
+}
+
+- (void)appendInt64:(int64_t)value
+{
+    [self appendUInt64:static_cast<uint64_t>(value) ^ leveldb_objc::sign_bit];
+}
+
+- (void)appendDouble:(double)value
+{
+    [self appendUInt64:leveldb_objc::order_preserving_value(value)];
+}
+
+- (void)appendBytes:(void const *)bytes length:(NSUInteger)length
+{
+    namespace ldb = leveldb_objc;
+    ldb::append_escaped(_buffer, bytes, length);
+    [_buffer appendBytes:ldb::terminator length:sizeof ldb::terminator];
+}
+
+- (void)appendData:(NSData *)data
+{
+    [self appendBytes:data.bytes length:data.length];
+}
+
+- (void)appendString:(NSString *)string
+{
+    namespace ldb = leveldb_objc;
+    char chunk[256];
+    NSUInteger used = 0;
+    NSRange remaining = NSMakeRange(0, string.length);
+    while (remaining.length) {
+        BOOL ok = [string getBytes:chunk
+                         maxLength:sizeof chunk
+                        usedLength:&used
+                          encoding:NSUTF8StringEncoding
+                           options:NSStringEncodingConversionAllowLossy
+                             range:remaining
+                    remainingRange:&remaining];
+        if (!ok || !used) break;
+        ldb::append_escaped(_buffer, chunk, used);
+    }
+    [_buffer appendBytes:ldb::terminator length:sizeof ldb::terminator];
+}
+
+- (void)appendUnescapedData:(NSData *)data
+{
+    [_buffer appendData:data];
+}
+
+@end // LDBTupleEncoder
+
+// -----------------------------------------------------------------------------
+#pragma mark - LDBTupleDecoder
+
+@implementation LDBTupleDecoder {
+    NSData *_data; // Keeps `_bytes` alive unless borrowed.
+    unsigned char const *_bytes;
+    NSUInteger _length;
+}
+
+- (instancetype)init
+{
+    @throw [NSException exceptionWithName:NSInternalInconsistencyException
+                                   reason:@"-init is not a valid initializer for the class LDBTupleDecoder"
+                                 userInfo:nil];
+    return nil;
+}
+
+- (instancetype)initWithData:(NSData *)data
+{
+    NSData *copy = [data copy];
+    if (!(self = [self initWithBytes:copy.bytes length:copy.length])) return nil;
+    _data = copy;
+    return self;
+}
+
+- (instancetype)initWithBytes:(void const *)bytes length:(NSUInteger)length
+{
+    if (!(self = [super init])) return nil;
+    _bytes = static_cast<unsigned char const *>(bytes);
+    _length = length;
+    return self;
+}
+
+- (BOOL)isAtEnd
+{
+    return _offset >= _length;
+}
+
+- (BOOL)private_read:(void *)bytes length:(NSUInteger)length
+{
+    if (_length - _offset < length) return NO;
+    std::memcpy(bytes, _bytes + _offset, length);
+    _offset += length;
+    return YES;
+}
+
+- (BOOL)decodeUInt8:(uint8_t *)value
+{
+    return [self private_read:value length:sizeof *value];
+}
+
+- (BOOL)decodeInt8:(int8_t *)value
+{
+    uint8_t u;
+    if (![self decodeUInt8:&u]) return NO;
+    *value = static_cast<int8_t>(u ^ uint8_t(0x80));
+    return YES;
+}
+
+- (BOOL)decodeUInt16:(uint16_t *)value
+{
+    uint16_t bigEndian;
+    if (![self private_read:&bigEndian length:sizeof bigEndian]) return NO;
+    *value = CFSwapInt16BigToHost(bigEndian);
+    return YES;
+}
+
+- (BOOL)decodeInt16:(int16_t *)value
+{
+    uint16_t u;
+    if (![self decodeUInt16:&u]) return NO;
+    *value = static_cast<int16_t>(u ^ uint16_t(0x8000));
+    return YES;
+}
+
+- (BOOL)decodeUInt32:(uint32_t *)value
+{
+    uint32_t bigEndian;
+    if (![self private_read:&bigEndian length:sizeof bigEndian]) return NO;
+    *value = CFSwapInt32BigToHost(bigEndian);
+    return YES;
+}
+
+- (BOOL)decodeInt32:(int32_t *)value
+{
+    uint32_t u;
+    if (![self decodeUInt32:&u]) return NO;
+    *value = static_cast<int32_t>(u ^ (uint32_t(1) << 31));
+    return YES;
+}
+
+- (BOOL)decodeUInt64:(uint64_t *)value
+{
+    uint64_t bigEndian;
+    if (![self private_read:&bigEndian length:sizeof bigEndian]) return NO;
+    *value = CFSwapInt64BigToHost(bigEndian);
+    return YES;
+}
+
+- (BOOL)decodeInt64:(int64_t *)value
+{
+    uint64_t u;
+    if (![self decodeUInt64:&u]) return NO;
+    *value = static_cast<int64_t>(u ^ leveldb_objc::sign_bit);
+    return YES;
+}
+
+- (BOOL)decodeDouble:(double *)value
+{
+    uint64_t u;
+    if (![self decodeUInt64:&u]) return NO;
+    *value = leveldb_objc::from_order_preserving_value(u);
+    return YES;
+}
+
+- (NSRange)decodeBytesRange
+{
+    for (NSUInteger i = _offset; i + 1 < _length; i++) {
+        if (_bytes[i] != 0x00) continue;
+        if (_bytes[i + 1] == 0xff) {
+            i++;
+        } else if (_bytes[i + 1] == 0x01) {
+            auto const range = NSMakeRange(_offset, i - _offset);
+            _offset = i + 2;
+            return range;
+        } else {
+            break;
+        }
+    }
+    return NSMakeRange(NSNotFound, 0);
+}
+
+- (NSData *)decodeData
+{
+    auto const range = [self decodeBytesRange];
+    if (range.location == NSNotFound) return nil;
+
+    auto result = [NSMutableData dataWithCapacity:range.length];
+    auto p = _bytes + range.location;
+    auto const end = p + range.length;
+    while (p < end) {
+        auto zero = static_cast<unsigned char const *>(std::memchr(p, 0, end - p));
+        if (!zero) {
+            [result appendBytes:p length:end - p];
+            break;
+        }
+        [result appendBytes:p length:zero - p + 1]; // keep the 0x00, skip 0xff
+        p = zero + 2;
+    }
+    return [result copy];
+}
+
+- (NSString *)decodeString
+{
+    auto const offset = _offset;
+    NSData *data = [self decodeData];
+    NSString *string = data ? [[NSString alloc] initWithData:data encoding:NSUTF8StringEncoding] : nil;
+    if (!string) _offset = offset;
+    return string;
+}
+
+@end // LDBTupleDecoder
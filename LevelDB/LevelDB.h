@@ -25,6 +25,7 @@ FOUNDATION_EXPORT const unsigned char LevelDBVersionString[];
 #import <LevelDB/LDBInterval.h>
 #import <LevelDB/LDBLogger.h>
 #import <LevelDB/LDBSnapshot.h>
+#import <LevelDB/LDBTuple.h>
 #import <LevelDB/LDBWriteBatch.h>
 #import <LevelDB/NSData+LDB.h>
 
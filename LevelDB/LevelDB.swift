@@ -25,6 +25,7 @@ public extension LDBDatabase {
                                compression:          LDBCompression? = nil,
                                reuseLogs:            Bool?           = nil,
                                bloomFilterBits:      Int?            = nil,
+                               logSizeLimit:         Int?            = nil,
                                // Suppress trailing closure warning for infoLog.
                                _ignored: (() -> ())? = nil) -> [String: AnyObject]
     {
@@ -41,6 +42,7 @@ public extension LDBDatabase {
         if let x = compression     { opts[LDBOptionCompression] = x.rawValue as AnyObject? }
         if let x = reuseLogs       { opts[LDBOptionReuseLogs] = x as AnyObject? }
         if let x = bloomFilterBits { opts[LDBOptionBloomFilterBits] = x as AnyObject? }
+        if let x = logSizeLimit    { opts[LDBOptionLogSizeLimit] = x as AnyObject? }
         return opts
     }
 
@@ -107,6 +109,53 @@ extension LDBInterval {
     }
 }
 
+extension LDBTupleDecoder {
+    public func decodeUInt8() -> UInt8? {
+        var x: UInt8 = 0
+        return decodeUInt8(&x) ? x : nil
+    }
+
+    public func decodeInt8() -> Int8? {
+        var x: Int8 = 0
+        return decodeInt8(&x) ? x : nil
+    }
+
+    public func decodeUInt16() -> UInt16? {
+        var x: UInt16 = 0
+        return decodeUInt16(&x) ? x : nil
+    }
+
+    public func decodeInt16() -> Int16? {
+        var x: Int16 = 0
+        return decodeInt16(&x) ? x : nil
+    }
+
+    public func decodeUInt32() -> UInt32? {
+        var x: UInt32 = 0
+        return decodeUInt32(&x) ? x : nil
+    }
+
+    public func decodeInt32() -> Int32? {
+        var x: Int32 = 0
+        return decodeInt32(&x) ? x : nil
+    }
+
+    public func decodeUInt64() -> UInt64? {
+        var x: UInt64 = 0
+        return decodeUInt64(&x) ? x : nil
+    }
+
+    public func decodeInt64() -> Int64? {
+        var x: Int64 = 0
+        return decodeInt64(&x) ? x : nil
+    }
+
+    public func decodeDouble() -> Double? {
+        var x: Double = 0
+        return decodeDouble(&x) ? x : nil
+    }
+}
+
 public struct LDBIterator : IteratorProtocol {
 
     public let enumerator: LDBEnumerator
@@ -219,23 +268,64 @@ public final class Database<Key : DataSerializable & Comparable,
         _raw = database
     }
     
+    /// Index entry keys for a row (serialized key, value) of each index added
+    /// with `addIndex`.
+    internal var indexEntryKeys: [(Data, Value) -> Data?] = []
+    
+    /// The prefixes of the indexes added with `addIndex`.
+    internal var indexPrefixes: [Data] = []
+    
+    /// The smallest prefix of the indexes added with `addIndex`. Rows sort
+    /// before it, and the index entries from it on.
+    internal var indexStart: Data?
+    
+    /// Serializes the writes through `self` with reading the old values for
+    /// the index entries and with adding indexes, and guards the index state
+    /// above.
+    internal let indexLock = NSLock()
+    
+    /// `indexStart` as read under `indexLock`.
+    fileprivate var lockedIndexStart: Data? {
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        return indexStart
+    }
+    
     public subscript(key: Key) -> Value? {
         get {
             return raw[key.serializedData as Data].flatMap(Value.fromSerializedData)
         }
         set {
-            raw[key.serializedData as Data] = newValue?.serializedData as Data?
+            indexLock.lock()
+            defer { indexLock.unlock() }
+            if indexEntryKeys.isEmpty {
+                raw[key.serializedData as Data] = newValue?.serializedData as Data?
+            } else {
+                let batch = LDBWriteBatch()
+                batch[key.serializedData as Data] = newValue?.serializedData as Data?
+                _ = try? writeIndexed(batch, sync: false)
+            }
         }
     }
     
+    /// Snapshot of the rows, excluding the entries of the indexes added with
+    /// `addIndex`.
     public func snapshot() -> Snapshot<Key, Value> {
-        return Snapshot(raw.snapshot())
+        let snapshot = raw.snapshot()
+        guard let end = lockedIndexStart else { return Snapshot(snapshot) }
+        return Snapshot(snapshot.clamp(to: end), unclamped: snapshot)
     }
     
     public func write(_ batch: WriteBatch<Key, Value>,
                       sync: Bool) throws
     {
-        try raw.write(batch.raw, sync: sync)
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        if indexEntryKeys.isEmpty {
+            try raw.write(batch.raw, sync: sync)
+        } else {
+            try writeIndexed(batch.raw, sync: sync)
+        }
     }
     
     /// Convenience function to write the batch as set in `block`.
@@ -247,11 +337,17 @@ public final class Database<Key : DataSerializable & Comparable,
         try write(batch, sync: sync)
     }
     
+    /// The interval of rows from `start` to `end`, before `indexStart`.
+    fileprivate func rowInterval(_ start: Key?, _ end: Key?, _ indexStart: Data?) -> LDBInterval {
+        let interval = LDBInterval(start: start?.serializedData,
+                                   end: end?.serializedData)
+        guard let indexStart = indexStart else { return interval }
+        return LDBInterval(to: indexStart).clamp(interval)
+    }
+    
     public func approximateSizes(_ intervals: [(Key?, Key?)]) -> [UInt64] {
-        let dataIntervals = intervals.map {start, end in
-            LDBInterval(start: start?.serializedData,
-                        end: end?.serializedData)
-        }
+        let indexStart = lockedIndexStart
+        let dataIntervals = intervals.map {start, end in rowInterval(start, end, indexStart)}
         return raw.approximateSizes(for: dataIntervals).map {n in
             n.uint64Value
         }
@@ -261,6 +357,18 @@ public final class Database<Key : DataSerializable & Comparable,
         return approximateSizes([(start, end)])[0]
     }
 
+    public func approximateCounts(_ intervals: [(Key?, Key?)]) -> [UInt64] {
+        let indexStart = lockedIndexStart
+        let dataIntervals = intervals.map {start, end in rowInterval(start, end, indexStart)}
+        return raw.approximateCounts(for: dataIntervals).map {n in
+            n.uint64Value
+        }
+    }
+
+    public func approximateCount(from start: Key?, to end: Key?) -> UInt64 {
+        return approximateCounts([(start, end)])[0]
+    }
+
     public func compactInterval(_ start: Key?, _ end: Key?) {
         raw.compactInterval(LDBInterval(start: start?.serializedData as Data?,
                                         end:   end?.serializedData as Data?))
@@ -274,13 +382,25 @@ public struct Snapshot<Key : DataSerializable & Comparable,
     
     public let raw: LDBSnapshot
     
+    /// The snapshot `raw` was derived from, covering the index entries too.
+    internal let unclamped: LDBSnapshot
+    
     public init(_ snapshot: LDBSnapshot) {
+        self.init(snapshot, unclamped: snapshot)
+    }
+    
+    internal init(_ snapshot: LDBSnapshot, unclamped: LDBSnapshot) {
         self.raw = snapshot
+        self.unclamped = unclamped
+    }
+    
+    fileprivate func derive(_ snapshot: LDBSnapshot) -> Snapshot {
+        return Snapshot(snapshot, unclamped: unclamped)
     }
     
-    public var noncaching:  Snapshot { return Snapshot(raw.noncaching) }
-    public var checksummed: Snapshot { return Snapshot(raw.checksummed) }
-    public var reversed:    Snapshot { return Snapshot(raw.reversed) }
+    public var noncaching:  Snapshot { return derive(raw.noncaching) }
+    public var checksummed: Snapshot { return derive(raw.checksummed) }
+    public var reversed:    Snapshot { return derive(raw.reversed) }
     
     public var isNoncaching:  Bool { return raw.isNoncaching }
     public var isChecksummed: Bool { return raw.isChecksummed }
@@ -288,42 +408,42 @@ public struct Snapshot<Key : DataSerializable & Comparable,
     public var isClamped:     Bool { return raw.isClamped }
     
     public func prefixed(_ prefix: Key) -> Snapshot {
-        return Snapshot(raw.prefixed(prefix.serializedData as Data))
+        return derive(raw.prefixed(prefix.serializedData as Data))
     }
     
     public func clamp(from: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(from: from?.serializedData as Data?))
+        return derive(raw.clamp(from: from?.serializedData as Data?))
     }
     
     public func clamp(after: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(after: after?.serializedData as Data?))
+        return derive(raw.clamp(after: after?.serializedData as Data?))
     }
     
     public func clamp(to: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(to: to?.serializedData as Data?))
+        return derive(raw.clamp(to: to?.serializedData as Data?))
     }
     
     public func clamp(through: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(through: through?.serializedData as Data?))
+        return derive(raw.clamp(through: through?.serializedData as Data?))
     }
 
     public func clamp(from: Key?, to: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(from: from?.serializedData as Data?,
+        return derive(raw.clamp(from: from?.serializedData as Data?,
                                   to: to?.serializedData as Data?))
     }
     
     public func clamp(from: Key?, through: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(from: from?.serializedData as Data?,
+        return derive(raw.clamp(from: from?.serializedData as Data?,
                                   through: through?.serializedData as Data?))
     }
     
     public func clamp(after: Key?, to: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(after: after?.serializedData as Data?,
+        return derive(raw.clamp(after: after?.serializedData as Data?,
                                   to: to?.serializedData as Data?))
     }
     
     public func clamp(after: Key?, through: Key?) -> Snapshot {
-        return Snapshot(raw.clamp(after: after?.serializedData as Data?,
+        return derive(raw.clamp(after: after?.serializedData as Data?,
                                   through: through?.serializedData as Data?))
     }
     
@@ -346,16 +466,23 @@ public struct SnapshotGenerator<Key : DataSerializable & Comparable,
 {
     public typealias Element = (key: Key, value: Value)
 
-    fileprivate var iterator: LDBIterator
+    fileprivate let enumerator: LDBEnumerator
     
     internal init(snapshot: Snapshot<Key, Value>) {
-        self.iterator = snapshot.raw.makeIterator()
+        self.enumerator = snapshot.raw.enumerator()
     }
     
     public mutating func next() -> Element? {
-        while let (k, v) = iterator.next() {
-            if let key = Key.fromSerializedData(k),
-               let value = Value.fromSerializedData(v)
+        // Decode straight from the enumerator's current slice instead of
+        // copying the key and value into `Data` first.
+        while enumerator.isValid {
+            defer { enumerator.step() }
+            let k = UnsafeRawBufferPointer(start: enumerator.keyBytes,
+                                           count: Int(enumerator.keyLength))
+            let v = UnsafeRawBufferPointer(start: enumerator.valueBytes,
+                                           count: Int(enumerator.valueLength))
+            if let key = Key.fromSerializedBytes(k),
+               let value = Value.fromSerializedBytes(v)
             {
                 return (key: key, value: value)
             }
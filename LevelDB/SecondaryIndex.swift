@@ -0,0 +1,364 @@
+//
+//  SecondaryIndex.swift
+//  LevelDB-Cocoa
+//
+//  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
+//
+
+import Foundation
+
+/// Secondary index of the rows of a `Database<Key, Value>` by the index key
+/// `indexKey(value)`. Rows for which `indexKey` returns `nil` are not indexed.
+///
+/// For each indexed row, the database keeps an entry at the key made of
+/// `prefix`, the escaped index key and the primary key (see `LDBTupleEncoder`),
+/// and updates it in the same `LDBWriteBatch` as the row itself. The key
+/// `prefix` itself marks the index as built.
+///
+/// The entries share the key space of the database with the rows, which must
+/// all sort before `prefix`. For example, UTF-8 encoded `String` keys sort
+/// before any prefix starting with the byte `0xff`. Fixed-width integer keys
+/// have no such prefix, so indexes are not supported for them: `addIndex`
+/// fails if there are rows at or after `prefix`, and so do writes of such rows
+/// once the index is added.
+public final class SecondaryIndex<IndexKey : DataSerializable & Comparable,
+                                  Key : DataSerializable & Comparable,
+                                  Value : DataSerializable>
+{
+    public let prefix: Data
+    public let indexKey: (Value) -> IndexKey?
+
+    public init(prefix: Data, indexKey: @escaping (Value) -> IndexKey?) {
+        self.prefix = prefix
+        self.indexKey = indexKey
+    }
+
+    /// The key of the index entry for the row with the serialized `key` and
+    /// `value`, or `nil` if the row isn't indexed.
+    internal func entryKey(_ key: Data, _ value: Value) -> Data? {
+        guard let indexKey = indexKey(value) else { return nil }
+        let encoder = LDBTupleEncoder(capacity: UInt(prefix.count + key.count) + 32)
+        encoder.appendUnescapedData(prefix)
+        encoder.appendData(indexKey.serializedData)
+        encoder.appendUnescapedData(key)
+        return encoder.data
+    }
+
+    /// The escaped `indexKey` that follows `prefix` in the index entry keys.
+    internal func encodedIndexKey(_ indexKey: IndexKey) -> Data {
+        let encoder = LDBTupleEncoder()
+        encoder.appendData(indexKey.serializedData)
+        return encoder.data
+    }
+}
+
+/// The value of the key `prefix` of a built index.
+private let builtMarker = "LDBSecondaryIndex".data(using: .utf8)!
+
+private func indexError(_ message: String) -> NSError {
+    return NSError(domain: LDBErrorDomain,
+                   code: LDBError.invalidArgument.rawValue,
+                   userInfo: [LDBErrorMessageKey: message,
+                              NSLocalizedDescriptionKey: message])
+}
+
+/// Test whether `key` is shaped like an index entry under `prefix`: the
+/// escaped index key followed by the primary key, with an empty value.
+private func isEntry(_ key: Data, _ value: Data, prefix: Data) -> Bool {
+    guard value.isEmpty && key.count > prefix.count else { return false }
+    let decoder = LDBTupleDecoder(data: key.subdata(in: prefix.count ..< key.count))
+    return decoder.decodeBytesRange().location != NSNotFound
+}
+
+/// The least key after all keys starting with `prefix`, or `nil` if none.
+private func prefixEnd(_ prefix: Data) -> Data? {
+    var end = prefix
+    while let last = end.last {
+        end.removeLast()
+        if last < 0xff {
+            end.append(last + 1)
+            return end
+        }
+    }
+    return nil
+}
+
+extension Database {
+
+    /// Maintain `index` in every write through `self` from now on, and exclude
+    /// its entries from `snapshot()`, `approximateSizes` and
+    /// `approximateCounts`. Rows written through `raw` directly are not
+    /// indexed.
+    ///
+    /// If the index has not been built before (such as in an earlier run of
+    /// the app), it is built by scanning the rows, so that the index is
+    /// complete. Use `rebuildIndex` if the rows or `index.indexKey` may have
+    /// changed without the index being maintained, or use a new `prefix`.
+    ///
+    /// Throws an `LDBError.invalidArgument` error without changing anything if
+    /// `index.prefix` and the prefix of another index (added or built before)
+    /// are prefixes of each other, or if there are keys at or after
+    /// `index.prefix` which are not index entries. Writing such keys through
+    /// `self` afterwards fails in the same way.
+    public func addIndex<IndexKey>(_ index: SecondaryIndex<IndexKey, Key, Value>) throws {
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        let snapshot = raw.snapshot()
+        try checkIndexSpace(snapshot, prefix: index.prefix)
+        if snapshot[index.prefix] != builtMarker {
+            try buildIndex(index, snapshot: snapshot)
+        }
+        indexEntryKeys.append(index.entryKey)
+        indexPrefixes.append(index.prefix)
+        indexStart = rowsEnd(index)
+    }
+
+    /// Remove all entries of `index` and build it again from the rows.
+    ///
+    /// Throws an `LDBError.invalidArgument` error without changing anything
+    /// where `addIndex` would, or if there are keys starting with
+    /// `index.prefix` which are not its entries.
+    public func rebuildIndex<IndexKey>(_ index: SecondaryIndex<IndexKey, Key, Value>) throws {
+        indexLock.lock()
+        defer { indexLock.unlock() }
+        let snapshot = raw.snapshot()
+        if !indexPrefixes.contains(index.prefix) {
+            try checkIndexSpace(snapshot, prefix: index.prefix)
+        }
+        try buildIndex(index, snapshot: snapshot)
+    }
+
+    /// The end of the rows once `index` is added.
+    private func rowsEnd<IndexKey>(_ index: SecondaryIndex<IndexKey, Key, Value>) -> Data {
+        guard let start = indexStart,
+              NSData.ldb_compareLeft(start, right: index.prefix).rawValue < 0
+        else { return index.prefix }
+        return start
+    }
+
+    /// Check that `prefix` overlaps no other index, and that the keys at or
+    /// after it all belong to indexes: those added, the one at `prefix`, or
+    /// ones built before, recognized by their built marker. Only the first key
+    /// of each index built before is read, so this doesn't scan the entries.
+    private func checkIndexSpace(_ snapshot: LDBSnapshot, prefix: Data) throws {
+        guard !prefix.isEmpty else {
+            throw indexError("empty index prefix")
+        }
+        for other in indexPrefixes where other.starts(with: prefix) || prefix.starts(with: other) {
+            throw indexError("index prefix \(prefix) overlaps \(other)")
+        }
+        for n in 1 ..< prefix.count where snapshot[prefix.subdata(in: 0 ..< n)] == builtMarker {
+            throw indexError("index prefix \(prefix) overlaps \(prefix.subdata(in: 0 ..< n))")
+        }
+
+        var next = snapshot.ceilKey(prefix)
+        while let key = next {
+            let value = snapshot[key] ?? Data()
+            let indexPrefix: Data
+            if let other = indexPrefixes.first(where: {p in key.starts(with: p)}) {
+                indexPrefix = other
+            } else if key == prefix && value == builtMarker {
+                indexPrefix = prefix
+            } else if key.starts(with: prefix) {
+                guard value != builtMarker else {
+                    throw indexError("index prefix \(prefix) overlaps \(key)")
+                }
+                guard isEntry(key, value, prefix: prefix) else {
+                    throw indexError("row key \(key) at or after index prefix \(prefix)")
+                }
+                next = snapshot.ceilKey((key as NSData).ldb_lexicographicalFirstChild())
+                continue
+            } else if value == builtMarker {
+                indexPrefix = key
+            } else {
+                throw indexError("row key \(key) at or after index prefix \(prefix)")
+            }
+            guard let end = prefixEnd(indexPrefix) else { return }
+            next = snapshot.ceilKey(end)
+        }
+    }
+
+    /// Replace the entries of `index` with those of the rows in `snapshot` in
+    /// batches, writing the built marker last. Must be called with `indexLock`
+    /// held, so that no rows change meanwhile.
+    private func buildIndex<IndexKey>(_ index: SecondaryIndex<IndexKey, Key, Value>,
+                                      snapshot: LDBSnapshot) throws
+    {
+        let existing = snapshot.prefixed(index.prefix)
+        for (key, value) in existing {
+            guard key.isEmpty || isEntry(index.prefix + key, value, prefix: index.prefix) else {
+                throw indexError("row key \(index.prefix + key) within index prefix \(index.prefix)")
+            }
+        }
+
+        var batch = LDBWriteBatch()
+        var count = 0
+        func add(_ update: (LDBWriteBatch) -> ()) throws {
+            update(batch)
+            count += 1
+            if count == 1000 {
+                try raw.write(batch, sync: false)
+                batch = LDBWriteBatch()
+                count = 0
+            }
+        }
+
+        for key in existing.keys {
+            try add {b in b.removeData(forKey: index.prefix + key)}
+        }
+        for (key, data) in snapshot.clamp(to: rowsEnd(index)) {
+            guard let value = Value.fromSerializedData(data),
+                  let entryKey = index.entryKey(key, value)
+            else { continue }
+            try add {b in b[entryKey] = Data()}
+        }
+        batch[index.prefix] = builtMarker
+        try raw.write(batch, sync: false)
+    }
+
+    /// Write the raw `batch` along with the changes to the index entries of
+    /// the written rows in one atomic `LDBWriteBatch`. Must be called with
+    /// `indexLock` held, so that the old values read stay current until the
+    /// write.
+    internal func writeIndexed(_ batch: LDBWriteBatch, sync: Bool) throws {
+        var badKey: Data?
+        batch.enumerate {key, _ in
+            if badKey == nil && NSData.ldb_compareLeft(key, right: indexStart).rawValue >= 0 {
+                badKey = key
+            }
+        }
+        if let key = badKey {
+            throw indexError("row key \(key) at or after index prefix \(indexStart!)")
+        }
+
+        let snapshot = raw.snapshot()
+        let combined = LDBWriteBatch()
+        var written = [Data: Value?]()
+        batch.enumerate {key, data in
+            let old = written[key] ?? snapshot[key].flatMap(Value.fromSerializedData)
+            let new = data.flatMap(Value.fromSerializedData)
+            for entryKey in indexEntryKeys {
+                let oldEntry = old.flatMap {v in entryKey(key, v)}
+                let newEntry = new.flatMap {v in entryKey(key, v)}
+                if oldEntry != newEntry {
+                    if let e = oldEntry { combined.removeData(forKey: e) }
+                    if let e = newEntry { combined[e] = Data() }
+                }
+            }
+            combined[key] = data
+            written[key] = .some(new)
+        }
+        try raw.write(combined, sync: sync)
+    }
+}
+
+extension Snapshot {
+
+    /// The rows whose index key in `index` equals `indexKey`, in primary key
+    /// order.
+    ///
+    /// The index entries and rows are looked up from the snapshot of the whole
+    /// database `self` was derived from, regardless of any clamping.
+    public func rows<IndexKey>(in index: SecondaryIndex<IndexKey, Key, Value>,
+                               equalTo indexKey: IndexKey) -> IndexScan<Key, Value>
+    {
+        let entries = unclamped.prefixed(index.prefix).prefixed(index.encodedIndexKey(indexKey))
+        return IndexScan(rows: unclamped, entries: entries, hasIndexKey: false)
+    }
+
+    /// The rows whose index key in `index` is within `from ..< to`, in index
+    /// key order. A `nil` bound leaves that end of the interval open.
+    ///
+    /// The index entries and rows are looked up from the snapshot of the whole
+    /// database `self` was derived from, regardless of any clamping.
+    public func rows<IndexKey>(in index: SecondaryIndex<IndexKey, Key, Value>,
+                               from: IndexKey?,
+                               to: IndexKey?) -> IndexScan<Key, Value>
+    {
+        let entries = unclamped.prefixed(index.prefix)
+            .clamp(from: from.map(index.encodedIndexKey) ?? Data(),
+                   to: to.map(index.encodedIndexKey))
+        return IndexScan(rows: unclamped, entries: entries, hasIndexKey: true)
+    }
+}
+
+/// Sequence of the rows found through the entries of a `SecondaryIndex`.
+///
+/// The primary keys are read from the index in batches, and each batch of rows
+/// is looked up in key order before being returned in index order.
+public struct IndexScan<Key : DataSerializable & Comparable,
+                        Value : DataSerializable> : Sequence
+{
+    public typealias Element = (key: Key, value: Value)
+
+    fileprivate let rows: LDBSnapshot
+    fileprivate let entries: LDBSnapshot
+    fileprivate let hasIndexKey: Bool
+
+    public func makeIterator() -> IndexScanGenerator<Key, Value> {
+        return IndexScanGenerator(scan: self)
+    }
+}
+
+public struct IndexScanGenerator<Key : DataSerializable & Comparable,
+                                 Value : DataSerializable> : IteratorProtocol
+{
+    public typealias Element = (key: Key, value: Value)
+
+    fileprivate static var batchSize: Int { return 64 }
+
+    fileprivate let rows: LDBSnapshot
+    fileprivate let enumerator: LDBEnumerator
+    fileprivate let hasIndexKey: Bool
+    fileprivate var buffer: [Element] = [] // In reverse order.
+
+    fileprivate init(scan: IndexScan<Key, Value>) {
+        self.rows = scan.rows
+        self.enumerator = scan.entries.enumerator()
+        self.hasIndexKey = scan.hasIndexKey
+    }
+
+    public mutating func next() -> Element? {
+        while buffer.isEmpty && enumerator.isValid {
+            fill()
+        }
+        return buffer.popLast()
+    }
+
+    private mutating func fill() {
+        var keys = [Data]()
+        while keys.count < IndexScanGenerator.batchSize && enumerator.isValid {
+            if let key = primaryKey() {
+                keys.append(key)
+            }
+            enumerator.step()
+        }
+
+        var values = [Data: Data]()
+        for key in keys.sorted(by: {a, b in NSData.ldb_compareLeft(a, right: b).rawValue < 0}) {
+            values[key] = rows[key]
+        }
+
+        // Entries whose row is missing or unreadable are skipped.
+        buffer = keys.reversed().flatMap {k -> Element? in
+            guard let v = values[k],
+                  let key = Key.fromSerializedData(k),
+                  let value = Value.fromSerializedData(v)
+            else { return nil }
+            return (key: key, value: value)
+        }
+    }
+
+    /// The primary key at the end of the current index entry.
+    private func primaryKey() -> Data? {
+        guard let bytes = enumerator.keyBytes else { return nil }
+        let length = Int(enumerator.keyLength)
+        var offset = 0
+        if hasIndexKey {
+            let decoder = LDBTupleDecoder(bytes: bytes, length: UInt(length))
+            guard decoder.decodeBytesRange().location != NSNotFound else { return nil }
+            offset = Int(decoder.offset)
+        }
+        return Data(bytes: bytes + offset, count: length - offset)
+    }
+}
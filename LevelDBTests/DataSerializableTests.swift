@@ -79,6 +79,24 @@ class DataSerializableTests : XCTestCase {
         XCTAssertEqual(equal(a, b), x == y, "\(a) and \(b) compare differently from \(x) and \(y)")
         XCTAssertEqual(less(a, b), x < y, "\(a) and \(b) compare differently from \(x) and \(y)")
         XCTAssertEqual(less(b, a), y < x, "\(b) and \(a) compare differently from \(y) and \(x)")
+        
+        checkBytes(a, equal: equal)
+        checkBytes(b, equal: equal)
+    }
+    
+    fileprivate func checkBytes<T : DataSerializable>(_ a: T, equal: (T, T) -> Bool) {
+        let x = a.serializedData
+        XCTAssertEqual(a.serializedByteCount, x.count, "byte count of \(a) differs from \(x)")
+        
+        var buffer = [UInt8](repeating: 0, count: x.count + 1)
+        let written = buffer.withUnsafeMutableBytes {p in a.serialize(into: p)}
+        XCTAssertEqual(written, x.count, "\(a) serialized into a wrong number of bytes")
+        XCTAssertEqual(Data(buffer[0 ..< written]), x, "\(a) serialized into different bytes")
+        
+        let a1: T? = buffer.withUnsafeBytes {p in
+            T.fromSerializedBytes(UnsafeRawBufferPointer(rebasing: p[0 ..< written]))
+        }
+        XCTAssert(a1.map {a1 in equal(a1, a)} ?? false, "\(a) failed to round trip the bytes")
     }
     
     fileprivate func check<T : DataSerializable & Comparable>(_ a: T, _ b: T) {
@@ -109,6 +127,16 @@ class DataSerializableTests : XCTestCase {
                 check(a, b)
             }
         }
+        
+        let empty = UnsafeRawBufferPointer(start: nil, count: 0)
+        XCTAssertEqual(String.fromSerializedBytes(empty), "")
+        let invalid: [UInt8] = [0x61, 0xff, 0x62]
+        invalid.withUnsafeBytes {bytes in
+            XCTAssertNil(String.fromSerializedBytes(bytes))
+        }
+        "äö€".utf8.map {$0}.withUnsafeBytes {bytes in
+            XCTAssertEqual(String.fromSerializedBytes(bytes), "äö€")
+        }
     }
     
     func testNSData() {
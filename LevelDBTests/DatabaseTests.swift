@@ -208,6 +208,88 @@ class DatabaseTests : XCTestCase {
         XCTAssertEqual(db["foo".UTF8], "bar".UTF8)
     }
     
+    func testRecoveryStatistics() {
+        let options = LDBDatabase.options(createIfMissing: true,
+                                          writeBufferSize: 1 << 20,
+                                          reuseLogs: true,
+                                          logSizeLimit: 64 << 10)
+        let value = Data(count: 1000)
+        do {
+            let db = try LDBDatabase(path: path, options: options)
+            XCTAssertEqual(db.recoveryStatistics[LDBRecoveryLogRecords], 0)
+            for i in 0 ..< 50 {
+                db[String(i).UTF8] = value
+            }
+        } catch let error as NSError {
+            return XCTFail(error.description)
+        }
+        do {
+            let db = try LDBDatabase(path: path, options: options)
+            let stats = db.recoveryStatistics
+            XCTAssertEqual(stats[LDBRecoveryLogFiles], 1)
+            XCTAssertEqual(stats[LDBRecoveryLogRecords], 50)
+            XCTAssertGreaterThan(stats[LDBRecoveryLogBytes]?.intValue ?? 0, 50_000)
+            XCTAssertGreaterThan(stats[LDBRecoveryManifestBytes]?.intValue ?? 0, 0)
+            for i in 0 ..< 200 {
+                db[String(i).UTF8] = value
+            }
+        } catch let error as NSError {
+            return XCTFail(error.description)
+        }
+        do {
+            let db = try LDBDatabase(path: path, options: options)
+            let stats = db.recoveryStatistics
+            // The live log and possibly the one whose flush was cut short by
+            // closing, each past the limit by at most one write.
+            XCTAssertLessThanOrEqual(stats[LDBRecoveryLogBytes]?.intValue ?? .max, 2 * ((64 << 10) + 1100))
+            XCTAssertEqual(db["199".UTF8], value)
+        } catch let error as NSError {
+            return XCTFail(error.description)
+        }
+        XCTAssertEqual(LDBDatabase().recoveryStatistics.count, 0)
+    }
+    
+    func testApproximateCounts() {
+        let db: Database<UInt32, String>
+        do {
+            db = Database(try LDBDatabase(path: path, options: LDBDatabase.options(
+                createIfMissing: true,
+                writeBufferSize: 64 << 10,
+                blockSize: 1024)))
+        } catch let error as NSError {
+            return XCTFail(error.description)
+        }
+        
+        for i in 0 ..< UInt32(10_000) {
+            db[i] = "value \(i)"
+        }
+        db.raw.compactInterval(LDBInterval.everything())
+        
+        let counts = db.approximateCounts([(nil, nil), (0, 5_000), (9_000, nil), (20_000, nil)])
+        XCTAssertEqualWithAccuracy(Double(counts[0]), 10_000, accuracy: 500)
+        XCTAssertEqualWithAccuracy(Double(counts[1]), 5_000, accuracy: 1_000)
+        XCTAssertEqualWithAccuracy(Double(counts[2]), 1_000, accuracy: 500)
+        XCTAssertEqual(counts[3], 0)
+        
+        let interval = LDBInterval(start: UInt32(1_000).serializedData,
+                                   end: UInt32(9_000).serializedData)
+        let splits = db.raw.approximateSplitKeys(for: interval, count: 4)
+        XCTAssertEqual(splits.count, 3)
+        XCTAssertEqual(splits, splits.sorted(by: <))
+        for key in splits {
+            XCTAssert(interval.contains(key), "\(key) not in \(interval)")
+        }
+        XCTAssertEqual(db.raw.approximateSplitKeys(for: LDBInterval.nothing(), count: 4), [])
+        
+        for i in 20_000 ..< UInt32(25_000) {
+            db[i] = "value \(i)"
+        }
+        db.raw.compactInterval(LDBInterval.everything())
+        let more = db.approximateCounts([(nil, nil), (20_000, nil)])
+        XCTAssertEqualWithAccuracy(Double(more[0]), 15_000, accuracy: 750)
+        XCTAssertEqualWithAccuracy(Double(more[1]), 5_000, accuracy: 500)
+    }
+    
     func testPerformanceExample() {
         // This is an example of a performance test case.
         self.measure() {
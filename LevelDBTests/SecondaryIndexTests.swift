@@ -0,0 +1,179 @@
+//
+//  SecondaryIndexTests.swift
+//  LevelDB
+//
+//  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
+//
+
+import Foundation
+import XCTest
+import LevelDB
+
+class SecondaryIndexTests : XCTestCase {
+
+    // Rows keyed by name with the city after the colon in the value.
+    let byCity = SecondaryIndex<String, String, String>(prefix: Data(bytes: 0xff, 0x01)) {value in
+        value.components(separatedBy: ":").dropFirst().first
+    }
+
+    func names(_ rows: IndexScan<String, String>) -> [String] {
+        return rows.map {key, _ in key}
+    }
+
+    func testMaintainedOnWrites() {
+        let db = Database<String, String>()
+        try! db.addIndex(byCity)
+
+        db["alice"] = "Alice:Helsinki"
+        db["bob"]   = "Bob:Espoo"
+        db["carol"] = "Carol:Helsinki"
+        db["dave"]  = "Dave"
+
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice", "carol"])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Espoo")), ["bob"])
+
+        db["alice"] = "Alice:Espoo"
+        db["carol"] = nil
+
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), [])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Espoo")), ["alice", "bob"])
+
+        let rows = Array(db.snapshot().rows(in: byCity, equalTo: "Espoo"))
+        XCTAssertEqual(rows.map {_, v in v}, ["Alice:Espoo", "Bob:Espoo"])
+    }
+
+    func testWriteBatch() {
+        let db = Database<String, String>()
+        try! db.addIndex(byCity)
+        db["alice"] = "Alice:Helsinki"
+
+        do {
+            try db.write(sync: false) {batch in
+                batch["bob"]   = "Bob:Turku"
+                batch["alice"] = "Alice:Turku"
+                batch["bob"]   = "Bob:Vantaa"
+                batch["eve"]   = "Eve:Helsinki"
+            }
+        } catch let error as NSError {
+            return XCTFail(error.description)
+        }
+
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["eve"])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Turku")), ["alice"])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Vantaa")), ["bob"])
+    }
+
+    func testBuildsExistingRows() {
+        let db = Database<String, String>()
+        db["alice"] = "Alice:Helsinki"
+        db["bob"]   = "Bob:Espoo"
+        try! db.addIndex(byCity)
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice"])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Espoo")), ["bob"])
+
+        db.raw["bob".UTF8] = "Bob:Helsinki".UTF8
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice"])
+        try! db.rebuildIndex(byCity)
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice", "bob"])
+        XCTAssertEqual(names(db.snapshot().rows(in: byCity, equalTo: "Espoo")), [])
+    }
+
+    func testSnapshotExcludesEntries() {
+        let db = Database<Data, String>()
+        let index = SecondaryIndex<String, Data, String>(prefix: Data(bytes: 0xff)) {value in value}
+        try! db.addIndex(index)
+        for i in 0 ..< 100 {
+            db["key \(i)".UTF8] = "value \(i % 3)"
+        }
+
+        XCTAssertEqual(Array(db.snapshot()).count, 100)
+        XCTAssertEqual(Array(db.snapshot().reversed).count, 100)
+        XCTAssertEqual(Array(db.snapshot().rows(in: index, equalTo: "value 0")).count, 34)
+        XCTAssertEqual(Array(db.snapshot().clamp(from: "key 5".UTF8).rows(in: index, from: nil, to: nil)).count, 100)
+    }
+
+    func testRejectsRowsInIndexSpace() {
+        let db = Database<Data, String>()
+        let index = SecondaryIndex<String, Data, String>(prefix: Data(bytes: 0xff)) {value in value}
+        db["a".UTF8] = "x"
+        db[Data(bytes: 0xff, 0x05)] = "y"
+
+        XCTAssertThrowsError(try db.addIndex(index))
+        XCTAssertEqual(db[Data(bytes: 0xff, 0x05)], "y")
+        XCTAssertEqual(Array(db.snapshot()).count, 2)
+
+        db[Data(bytes: 0xff, 0x05)] = nil
+        db[Data(bytes: 0xff)] = ""
+        XCTAssertThrowsError(try db.addIndex(index))
+        XCTAssertEqual(db[Data(bytes: 0xff)], "")
+
+        db[Data(bytes: 0xff)] = nil
+        try! db.addIndex(index)
+        XCTAssertEqual(Array(db.snapshot().rows(in: index, equalTo: "x")).count, 1)
+        XCTAssertThrowsError(try db.write(sync: false) {batch in
+            batch[Data(bytes: 0xff, 0x05)] = "y"
+        })
+        db[Data(bytes: 0xff, 0x05)] = "y"
+        XCTAssertNil(db[Data(bytes: 0xff, 0x05)])
+    }
+
+    func testRejectsOverlappingPrefixes() {
+        let db = Database<String, String>()
+        db["alice"] = "Alice:Helsinki"
+        try! db.addIndex(byCity)
+        let shorter = SecondaryIndex<String, String, String>(prefix: Data(bytes: 0xff)) {value in value}
+        let longer = SecondaryIndex<String, String, String>(prefix: Data(bytes: 0xff, 0x01, 0x02)) {value in value}
+        XCTAssertThrowsError(try db.addIndex(shorter))
+        XCTAssertThrowsError(try db.addIndex(longer))
+
+        // Built in another run, but not added yet.
+        let reopened = Database<String, String>(db.raw)
+        XCTAssertThrowsError(try reopened.addIndex(shorter))
+        XCTAssertThrowsError(try reopened.addIndex(longer))
+        XCTAssertEqual(names(reopened.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice"])
+    }
+
+    func testAddsBuiltIndexesInAnyOrder() {
+        let db = Database<String, String>()
+        let byName = SecondaryIndex<String, String, String>(prefix: Data(bytes: 0xff, 0x02)) {value in
+            value.components(separatedBy: ":").first
+        }
+        try! db.addIndex(byCity)
+        try! db.addIndex(byName)
+        db["alice"] = "Alice:Helsinki"
+
+        let reopened = Database<String, String>(db.raw)
+        try! reopened.addIndex(byName)
+        try! reopened.addIndex(byCity)
+        reopened["bob"] = "Bob:Helsinki"
+        XCTAssertEqual(names(reopened.snapshot().rows(in: byCity, equalTo: "Helsinki")), ["alice", "bob"])
+        XCTAssertEqual(Array(reopened.snapshot()).count, 2)
+    }
+
+    func testConcurrentWrites() {
+        let db = Database<String, String>()
+        try! db.addIndex(byCity)
+        DispatchQueue.concurrentPerform(iterations: 100) {i in
+            db["alice"] = "Alice:city\(i)"
+        }
+        XCTAssertEqual(Array(db.snapshot().rows(in: byCity, from: nil, to: nil)).count, 1)
+    }
+
+    func testRangeScan() {
+        let db = Database<String, String>()
+        try! db.addIndex(byCity)
+        for i in 0 ..< 200 {
+            db["user\(i)"] = "User \(i):city\(i % 10)"
+        }
+
+        let snapshot = db.snapshot()
+        XCTAssertEqual(Array(snapshot.rows(in: byCity, from: nil, to: nil)).count, 200)
+        XCTAssertEqual(Array(snapshot.rows(in: byCity, from: "city3", to: "city5")).count, 40)
+
+        let cities = snapshot.rows(in: byCity, from: "city8", to: nil).map {_, v in
+            v.components(separatedBy: ":")[1]
+        }
+        XCTAssertEqual(cities, Array(repeating: "city8", count: 20) + Array(repeating: "city9", count: 20))
+    }
+
+}
@@ -0,0 +1,183 @@
+//
+//  TupleTests.swift
+//  LevelDB
+//
+//  Copyright (c) 2015 Pyry Jahkola. All rights reserved.
+//
+
+import Foundation
+import XCTest
+import LevelDB
+
+class TupleTests : XCTestCase {
+
+    typealias Row = (tenant: String, table: Data, timestamp: Double, id: Int64)
+
+    func encode(_ row: Row, into encoder: LDBTupleEncoder = LDBTupleEncoder()) -> Data {
+        encoder.reset()
+        encoder.appendString(row.tenant)
+        encoder.appendData(row.table)
+        encoder.appendDouble(row.timestamp)
+        encoder.appendInt64(row.id)
+        return encoder.data
+    }
+
+    // Listed in increasing order, component by component.
+    let rows: [Row] = [
+        ("",     Data(),                 0,    0),
+        ("",     Data(bytes: 0),         0,    0),
+        ("",     Data(bytes: 0, 0),      0,    0),
+        ("",     Data(bytes: 0, 1),      0,    0),
+        ("",     Data(bytes: 1),         0,    0),
+        ("",     Data(bytes: 255),      -1,    0),
+        ("",     Data(bytes: 255),       0, .min),
+        ("",     Data(bytes: 255),       0,   -1),
+        ("",     Data(bytes: 255),       0,    0),
+        ("",     Data(bytes: 255),       0, .max),
+        ("",     Data(bytes: 255, 255),  0,    0),
+        ("a",    Data(),         -.infinity,   0),
+        ("a",    Data(),              -2.5,    0),
+        ("a",    Data(),               0.5,    0),
+        ("a",    Data(),          .infinity,   0),
+        ("a\0",  Data(),                 0,    0),
+        ("ab",   Data(),                 0,    0),
+        ("äö",   Data(),                 0,    0),
+    ]
+
+    func testOrderPreserving() {
+        let encoder = LDBTupleEncoder(capacity: 32)
+        let keys = rows.map {row in encode(row, into: encoder)}
+        for (i, x) in keys.enumerated() {
+            for (j, y) in keys.enumerated() {
+                XCTAssertEqual(i < j, x < y, "\(rows[i]) vs. \(rows[j])")
+                XCTAssertEqual(i == j, x == y, "\(rows[i]) vs. \(rows[j])")
+            }
+        }
+    }
+
+    func testRoundTrip() {
+        for row in rows {
+            let decoder = LDBTupleDecoder(data: encode(row))
+            XCTAssertEqual(decoder.decodeString(), row.tenant)
+            XCTAssertEqual(decoder.decodeData(), row.table)
+            XCTAssertEqual(decoder.decodeDouble(), row.timestamp)
+            XCTAssertEqual(decoder.decodeInt64(), row.id)
+            XCTAssert(decoder.isAtEnd)
+            XCTAssertNil(decoder.decodeInt64())
+        }
+    }
+
+    func testMatchesDataSerializable() {
+        for x: Int64 in [.min, -1, 0, 1, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendInt64(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+        }
+        for x: Int32 in [.min, -1, 0, 1, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendInt32(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+        }
+        for x: Int16 in [.min, -1, 0, 1, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendInt16(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+            XCTAssertEqual(LDBTupleDecoder(data: encoder.data).decodeInt16(), x)
+        }
+        for x: Int8 in [.min, -1, 0, 1, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendInt8(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+            XCTAssertEqual(LDBTupleDecoder(data: encoder.data).decodeInt8(), x)
+        }
+        for x: UInt16 in [0, 1, 0x1234, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendUInt16(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+            XCTAssertEqual(LDBTupleDecoder(data: encoder.data).decodeUInt16(), x)
+        }
+        for x: UInt8 in [0, 1, .max] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendUInt8(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+            XCTAssertEqual(LDBTupleDecoder(data: encoder.data).decodeUInt8(), x)
+        }
+        for x: Double in [-.infinity, -1.5, -0.0, 0.0, .leastNonzeroMagnitude, 1e100, .infinity] {
+            let encoder = LDBTupleEncoder()
+            encoder.appendDouble(x)
+            XCTAssertEqual(encoder.data, x.serializedData)
+        }
+    }
+
+    func testBytesRange() {
+        let encoder = LDBTupleEncoder()
+        encoder.appendString("abc")
+        encoder.appendData(Data(bytes: 1, 0, 2))
+        encoder.appendUInt32(7)
+        let decoder = LDBTupleDecoder(data: encoder.data)
+        XCTAssertEqual(decoder.decodeBytesRange(), NSRange(location: 0, length: 3))
+        XCTAssertEqual(decoder.decodeBytesRange(), NSRange(location: 5, length: 4))
+        XCTAssertEqual(decoder.decodeUInt32(), 7)
+
+        let malformed = LDBTupleDecoder(data: Data(bytes: 1, 2, 0, 3))
+        XCTAssertEqual(malformed.decodeBytesRange().location, NSNotFound)
+        XCTAssertNil(malformed.decodeData())
+        XCTAssertEqual(malformed.offset, 0)
+    }
+
+    func testPrefixInterval() {
+        let db = LDBDatabase()
+        let encoder = LDBTupleEncoder()
+        for row in rows {
+            db[encode(row, into: encoder)] = Data()
+        }
+
+        encoder.reset()
+        encoder.appendString("")
+        encoder.appendData(Data(bytes: 255))
+        let prefix = encoder.prefixInterval
+        XCTAssertEqual(Array(db.snapshot().clamp(to: prefix).keys).count, 5)
+
+        encoder.appendDouble(0)
+        let start = encoder.data
+        encoder.appendInt64(0)
+        let interval = LDBInterval(start: start, end: encoder.data)
+        XCTAssertEqual(Array(db.snapshot().clamp(to: interval).keys).count, 2)
+
+        encoder.reset()
+        encoder.appendString("a")
+        XCTAssertEqual(Array(db.snapshot().clamp(to: encoder.prefixInterval).keys).count, 4)
+    }
+
+    func testRangeInterval() {
+        let db = LDBDatabase()
+        let encoder = LDBTupleEncoder()
+        for row in rows {
+            db[encode(row, into: encoder)] = Data()
+        }
+
+        func count(_ interval: LDBInterval) -> Int {
+            return Array(db.snapshot().clamp(to: interval).keys).count
+        }
+
+        encoder.reset()
+        encoder.appendString("a")
+        encoder.appendData(Data())
+        let before = encoder.data
+        XCTAssertEqual(count(encoder.interval(from: {e in e.appendDouble(-2.5)},
+                                              to: {e in e.appendDouble(.infinity)})), 2)
+        XCTAssertEqual(count(encoder.interval(from: {e in e.appendDouble(-2.5)},
+                                              through: {e in e.appendDouble(.infinity)})), 3)
+        XCTAssertEqual(count(encoder.interval(from: nil, to: {e in e.appendDouble(0)})), 2)
+        XCTAssertEqual(count(encoder.interval(from: {e in e.appendDouble(0)}, to: nil)), 2)
+        XCTAssertEqual(count(encoder.interval(from: nil, through: nil)), 4)
+        XCTAssertEqual(encoder.data, before)
+
+        encoder.reset()
+        encoder.appendString("")
+        let tables = encoder.interval(from: {e in e.appendData(Data(bytes: 0))},
+                                      to: {e in e.appendData(Data(bytes: 255))})
+        XCTAssertEqual(count(tables), 4)
+    }
+
+}